@@ -18,27 +18,31 @@
 // Memory manipulation
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void* nMalloc(int32_t size) {
+static void* nMalloc(int64_t size) {
     return malloc(size);
 }
 
+static void* nRealloc(void* address, int64_t size) {
+    return realloc(address, size);
+}
+
 static void nFree(void* address) {
     free(address);
 }
 
-static void* nMemset(void* address, int value, int32_t length) {
+static void* nMemset(void* address, int value, int64_t length) {
     return memset(address, value, length);
 }
 
-static void* nMemcpy(void* dest, const void* src, int32_t length) {
+static void* nMemcpy(void* dest, const void* src, int64_t length) {
     return memcpy(dest, src, length);
 }
 
-static void* nMemmove(void* dest, const void* src, int32_t length) {
+static void* nMemmove(void* dest, const void* src, int64_t length) {
     return memmove(dest, src, length);
 }
 
-static int32_t nMemcmp(const void* ptr1, const void* ptr2, int32_t length) {
+static int32_t nMemcmp(const void* ptr1, const void* ptr2, int64_t length) {
     return memcmp(ptr1, ptr2, length);
 }
 
@@ -46,20 +50,26 @@ static int32_t nMemcmp(const void* ptr1, const void* ptr2, int32_t length) {
 // Logging
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Log lines are formatted in stack buffers, so that short lines don't touch the heap,
+#define LOG_BUFFER_SIZE 256
+
 #define LOG_IMPLEMENTATION(logLevel, color) \
-    struct NString* formattedString = NString.create(""); \
+    char formattedBuffer[LOG_BUFFER_SIZE], coloredBuffer[LOG_BUFFER_SIZE]; \
+    struct NString formattedString, coloredString; \
+    NString.initializeWithBuffer(&formattedString, formattedBuffer, LOG_BUFFER_SIZE, ""); \
     va_list vaList; \
     va_start(vaList, format); \
     int32_t errorsStart = NError.observeErrors(); \
-    NString.vAppend(formattedString, format, vaList); \
+    NString.vAppend(&formattedString, format, vaList); \
     int32_t errorsCount = NError.observeErrors() - errorsStart; \
     va_end(vaList); \
     if (!errorsCount) { \
-        struct NString* coloredString = NString.replace(NString.get(formattedString), NTCOLOR(STREAM_DEFAULT), color); \
-        __android_log_print(logLevel, logTag ? logTag : "", "%s%s%s", color, NString.get(coloredString), NTCOLOR(RESET)); \
-        NString.destroyAndFree(coloredString); \
+        NString.initializeWithBuffer(&coloredString, coloredBuffer, LOG_BUFFER_SIZE, ""); \
+        NString.appendReplaced(&coloredString, NString.get(&formattedString), NTCOLOR(STREAM_DEFAULT), color); \
+        __android_log_print(logLevel, logTag ? logTag : "", "%s%s%s", color, NString.get(&coloredString), NTCOLOR(RESET)); \
+        NString.destroy(&coloredString); \
     } \
-    NString.destroyAndFree(formattedString)
+    NString.destroy(&formattedString)
 
 void logI(const char *logTag, const char *format, ...) { LOG_IMPLEMENTATION(ANDROID_LOG_INFO , NTCOLOR(RESET)); }
 void logW(const char *logTag, const char *format, ...) { LOG_IMPLEMENTATION(ANDROID_LOG_WARN , NTCOLOR(WARNING)); }
@@ -108,7 +118,8 @@ const struct NSystemUtils_Interface NSystemUtils = {
     .logE = logE,
     .getTime = getTime,
     .isNaN = isNaN,
-    .isInf = isInf
+    .isInf = isInf,
+    .realloc = nRealloc
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,10 @@
 #include <time.h>
 #include <math.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 #include <dirent.h>
 #include "../../Includes/NSystemUtils.h"
 
@@ -32,27 +36,33 @@ int main(int argc, char *argv[]) {
 // Memory manipulation
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void* nMalloc(int32_t size) {
+static void* nMalloc(int64_t size) {
     return malloc(size);
 }
 
+static void* nRealloc(void* address, int64_t size) {
+    // Note: glibc serves large blocks using mmap, and grows them using mremap, so growing very
+    // large buffers neither copies their contents nor doubles the peak memory usage.
+    return realloc(address, size);
+}
+
 static void nFree(void* address) {
     free(address);
 }
 
-static void* nMemset(void* address, int value, int32_t length) {
+static void* nMemset(void* address, int value, int64_t length) {
     return memset(address, value, length);
 }
 
-static void* nMemcpy(void* dest, const void* src, int32_t length) {
+static void* nMemcpy(void* dest, const void* src, int64_t length) {
     return memcpy(dest, src, length);
 }
 
-static void* nMemmove(void* dest, const void* src, int32_t length) {
+static void* nMemmove(void* dest, const void* src, int64_t length) {
     return memmove(dest, src, length);
 }
 
-static int32_t nMemcmp(const void* ptr1, const void* ptr2, int32_t length) {
+static int32_t nMemcmp(const void* ptr1, const void* ptr2, int64_t length) {
     return memcmp(ptr1, ptr2, length);
 }
 
@@ -60,24 +70,30 @@ static int32_t nMemcmp(const void* ptr1, const void* ptr2, int32_t length) {
 // Logging
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Log lines are formatted in stack buffers, so that short lines don't touch the heap,
+#define LOG_BUFFER_SIZE 256
+
 #define LOG_DEFINITION(tagColor, streamDefaultColor) \
-    struct NString* formattedString = NString.create(""); \
+    char formattedBuffer[LOG_BUFFER_SIZE], coloredBuffer[LOG_BUFFER_SIZE]; \
+    struct NString formattedString, coloredString; \
+    NString.initializeWithBuffer(&formattedString, formattedBuffer, LOG_BUFFER_SIZE, ""); \
     va_list vaList; \
     va_start(vaList, format); \
     int32_t errorsStart = NError.observeErrors(); \
-    NString.vAppend(formattedString, format, vaList); \
+    NString.vAppend(&formattedString, format, vaList); \
     int32_t errorsCount = NError.observeErrors() - errorsStart; \
     va_end(vaList); \
     if (!errorsCount) { \
-        struct NString* coloredString = NString.replace(NString.get(formattedString), NTCOLOR(STREAM_DEFAULT), streamDefaultColor); \
+        NString.initializeWithBuffer(&coloredString, coloredBuffer, LOG_BUFFER_SIZE, ""); \
+        NString.appendReplaced(&coloredString, NString.get(&formattedString), NTCOLOR(STREAM_DEFAULT), streamDefaultColor); \
         if (tag && tag[0]) { \
-            printf("%s%s: %s%s%s\n", tagColor, tag, streamDefaultColor, NString.get(coloredString), NTCOLOR(RESET)); \
+            printf("%s%s: %s%s%s\n", tagColor, tag, streamDefaultColor, NString.get(&coloredString), NTCOLOR(RESET)); \
         } else { \
-            printf("%s%s%s\n", streamDefaultColor, NString.get(coloredString), NTCOLOR(RESET)); \
+            printf("%s%s%s\n", streamDefaultColor, NString.get(&coloredString), NTCOLOR(RESET)); \
         } \
-        NString.destroyAndFree(coloredString); \
+        NString.destroy(&coloredString); \
     } \
-    NString.destroyAndFree(formattedString)
+    NString.destroy(&formattedString)
 
 static void nLogI(const char *tag, const char* format, ...) {
     LOG_DEFINITION(NTCOLOR(STREAM_DEFAULT_STRONG), NTCOLOR(RESET));
@@ -250,6 +266,65 @@ static boolean writeToFile(const char* filePath, const void *data, uint32_t size
     return writtenBytesCount;
 }
 
+// Buffers per writev() call. POSIX guarantees at least 16, Linux allows 1024,
+#define WRITE_BUFFERS_BATCH_SIZE 1024
+
+static boolean writeBuffersToFile(const char* filePath, const void* const* buffers, const int64_t* sizes, int32_t buffersCount, boolean append) {
+
+    // Open file,
+    int fileDescriptor = open(filePath, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    if (fileDescriptor < 0) {
+        NERROR("NSystemUtils.writeBuffersToFile()", "%sCouldn't open%s file for writing: %s%s%s.", NTCOLOR(HIGHLIGHT), NTCOLOR(STREAM_DEFAULT), NTCOLOR(HIGHLIGHT), filePath, NTCOLOR(STREAM_DEFAULT));
+        return False;
+    }
+
+    // Write all buffers in one call (per batch), resuming after partial writes,
+    struct iovec ioVectors[WRITE_BUFFERS_BATCH_SIZE];
+    int32_t bufferIndex=0;
+    int64_t bufferOffset=0;
+    boolean success=True;
+    while (True) {
+
+        // Skip written (or empty) buffers,
+        while ((bufferIndex < buffersCount) && (bufferOffset == sizes[bufferIndex])) {
+            bufferIndex++;
+            bufferOffset = 0;
+        }
+        if (bufferIndex == buffersCount) break;
+
+        int32_t ioVectorsCount=0;
+        for (int32_t i=bufferIndex; (i<buffersCount) && (ioVectorsCount<WRITE_BUFFERS_BATCH_SIZE); i++) {
+            int64_t offset = (i==bufferIndex) ? bufferOffset : 0;
+            ioVectors[ioVectorsCount].iov_base = ((uint8_t*) buffers[i]) + offset;
+            ioVectors[ioVectorsCount].iov_len = sizes[i] - offset;
+            ioVectorsCount++;
+        }
+
+        ssize_t writtenBytesCount = writev(fileDescriptor, ioVectors, ioVectorsCount);
+        if (writtenBytesCount <= 0) {
+            if ((writtenBytesCount < 0) && (errno == EINTR)) continue;
+            NERROR("NSystemUtils.writeBuffersToFile()", "%sCouldn't write%s to file: %s%s%s.", NTCOLOR(HIGHLIGHT), NTCOLOR(STREAM_DEFAULT), NTCOLOR(HIGHLIGHT), filePath, NTCOLOR(STREAM_DEFAULT));
+            success = False;
+            break;
+        }
+
+        // Advance past the written bytes,
+        while (writtenBytesCount) {
+            int64_t remainingBytesCount = sizes[bufferIndex] - bufferOffset;
+            if (writtenBytesCount < remainingBytesCount) {
+                bufferOffset += writtenBytesCount;
+                break;
+            }
+            writtenBytesCount -= remainingBytesCount;
+            bufferIndex++;
+            bufferOffset = 0;
+        }
+    }
+
+    close(fileDescriptor);
+    return success;
+}
+
 // Returns success,
 static boolean makeDirectory(const char* directoryPath) {
 
@@ -307,7 +382,9 @@ const struct NSystemUtils_Interface NSystemUtils = {
     .makeDirectory = makeDirectory,
     .getTime = getTime,
     .isNaN = isNaN,
-    .isInf = isInf
+    .isInf = isInf,
+    .realloc = nRealloc,
+    .writeBuffersToFile = writeBuffersToFile
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -16,33 +16,38 @@ int main() {
     return 0;
 }
 
-static void* nMalloc(int32_t size) {
+static void* nMalloc(int64_t size) {
     // TODO: implement...
     NSystemUtils.mallocCallsCount++;
     return 0;
 }
 
+static void* nRealloc(void* address, int64_t size) {
+    // TODO: implement...
+    return 0;
+}
+
 static void nFree(void* address) {
     NSystemUtils.freeCallsCount++;
     // TODO: implement...
 }
 
-static void* nMemset(void* address, int value, int32_t length) {
+static void* nMemset(void* address, int value, int64_t length) {
     // TODO: implement...
     return 0;
 }
 
-static void* nMemcpy(void* dest, const void* src, int32_t length) {
+static void* nMemcpy(void* dest, const void* src, int64_t length) {
     // TODO: implement...
     return 0;
 }
 
-static void* nMemmove(void* dest, const void* src, int32_t length) {
+static void* nMemmove(void* dest, const void* src, int64_t length) {
     // TODO: implement...
     return 0;
 }
 
-static int32_t nMemcmp(const void* ptr1, const void* ptr2, int32_t length) {
+static int32_t nMemcmp(const void* ptr1, const void* ptr2, int64_t length) {
     // TODO: implement...
     return 0;
 }
@@ -84,7 +89,8 @@ const struct NSystemUtils_Interface NSystemUtils = {
     .logE = nLogE,
     .getTime = getTime,
     .isNaN = isNaN,
-    .isInf = isInf
+    .isInf = isInf,
+    .realloc = nRealloc
 };
 
 const struct NTerminalColor NTerminalColor = {
@@ -0,0 +1,68 @@
+// Measures NHash throughput in GB/s, for XXH64 and for CRC-32C with each implementation (SSE4.2
+// and tables), on inputs of 64 bytes, 4KB and 1MB. Times are the best of several runs.
+//
+// NHash.c is included to force the CRC-32C implementation, so build it without it:
+//   gcc -O2 -IIncludes $(ls *.c | grep -v '^NHash.c$') Backends/Linux/NSystemUtils.c Benchmarks/NHashBenchmark.c -o NHashBenchmark -lm
+
+#include "../NHash.c"
+
+#include <stdio.h>
+
+#define TOTAL_SIZE (256*1024*1024) // Bytes hashed per run, whatever the input size.
+#define RUNS_COUNT 5
+
+static double getTimeSeconds() {
+    int64_t seconds, nanos;
+    NSystemUtils.getTime(&seconds, &nanos);
+    return seconds + nanos*1e-9;
+}
+
+// 0: XXH64, 1: CRC-32C,
+static double benchmark(int32_t hashType, const uint8_t* data, NVectorSize size) {
+    int64_t iterationsCount = TOTAL_SIZE / size;
+    volatile uint64_t result;
+    double bestTime = 1e9;
+    for (int32_t run=0; run<RUNS_COUNT; run++) {
+        uint64_t hash=0;
+        double startTime = getTimeSeconds();
+        for (int64_t i=0; i<iterationsCount; i++) {
+            hash += (hashType == 0) ? NHash.xxh64(data, size, i) : NHash.crc32c(data, size);
+        }
+        double time = getTimeSeconds() - startTime;
+        if (time < bestTime) bestTime = time;
+        result = hash;
+    }
+    (void) result;
+    return iterationsCount * (double) size / bestTime * 1e-9;
+}
+
+void NMain(int argc, char* argv[]) {
+
+    NVectorSize maxSize = 1024*1024;
+    uint8_t* data = NMALLOC(maxSize, "NHashBenchmark data");
+    for (NVectorSize i=0; i<maxSize; i++) data[i] = (uint8_t) (i * 2654435761U >> 24);
+
+    NVectorSize sizes[] = {64, 4096, 1024*1024};
+    printf("%-18s %10s %10s %10s\n", "GB/s", "64B", "4KB", "1MB");
+
+    printf("%-18s", "XXH64");
+    for (int32_t i=0; i<3; i++) printf(" %10.2f", benchmark(0, data, sizes[i]));
+    printf("\n");
+
+    #if NHASH_X86_SIMD
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32cImplementation = 1;
+        printf("%-18s", "CRC-32C (SSE4.2)");
+        for (int32_t i=0; i<3; i++) printf(" %10.2f", benchmark(1, data, sizes[i]));
+        printf("\n");
+    }
+    #endif
+
+    crc32cImplementation = 0;
+    printf("%-18s", "CRC-32C (tables)");
+    for (int32_t i=0; i<3; i++) printf(" %10.2f", benchmark(1, data, sizes[i]));
+    printf("\n");
+    crc32cImplementation = -1;
+
+    NFREE(data, "NHashBenchmark data");
+}
@@ -0,0 +1,230 @@
+// Measures formatting doubles through NString, in ns per value over 1,000,000 values (half with 3
+// fraction digits, like table data, half with full precision). Compares the shortest round-trip
+// formatter (%f, appendDouble) against the previous %f formatter, copied below, and against
+// snprintf("%.17g"), the shortest printf format that always round-trips. Build with the library
+// sources and a backend:
+//   gcc -O2 -IIncludes *.c Backends/Linux/NSystemUtils.c Benchmarks/NStringFloatBenchmark.c -o NStringFloatBenchmark -lm
+
+#include <NString.h>
+#include <NSystemUtils.h>
+
+#include <stdio.h>
+
+#define VALUES_COUNT 1000000
+#define RUNS_COUNT 5
+
+/////////////////////////////////////////////////////////////////////////////////////
+// The previous %f formatter (at most 7 fraction digits, doesn't round-trip)
+/////////////////////////////////////////////////////////////////////////////////////
+
+#define FLOAT_TO_STRING_MAX_INTEGER_DIGITS  19
+#define FLOAT_TO_STRING_MAX_FRACTION_DIGITS  7
+#define MIN_FLOAT_NORMALIZATION_EXPONENT     5
+
+struct FloatToStringConversionSettings {
+    int32_t maxIntegerDigitsCount;
+    int32_t maxFractionDigitsCount;
+    float lowerNormalizationThreshold;
+    float upperNormalizationThreshold;
+    uint64_t fractionDigitsShift;
+};
+
+static const struct FloatToStringConversionSettings DEFAULT_DOUBLE_CONVERSION_SETTINGS = {
+    .maxIntegerDigitsCount = FLOAT_TO_STRING_MAX_INTEGER_DIGITS,
+    .maxFractionDigitsCount = FLOAT_TO_STRING_MAX_FRACTION_DIGITS,
+    .upperNormalizationThreshold = 1e19,
+    .lowerNormalizationThreshold = 1e-5,
+    .fractionDigitsShift = 10*1e7
+};
+
+static inline int32_t positiveLongToDigits(char* outDigits, uint64_t longInteger) {
+    int32_t digitsCount=0;
+    do {
+        outDigits[digitsCount++] = longInteger % 10;
+        longInteger /= 10;
+    } while (longInteger);
+    return digitsCount;
+}
+
+static inline boolean appendDoubleToByteVector_HandleSignAndSpecialValues(struct NByteVector *outVector, double* value) {
+    if (NSystemUtils.isNaN(*value)) {
+        NByteVector.pushBack(outVector, 'n');
+        NByteVector.pushBack(outVector, 'a');
+        NByteVector.pushBack(outVector, 'n');
+        return True;
+    }
+    if (*value<0) {
+        NByteVector.pushBack(outVector, '-');
+        *value = 0 - *value;
+    }
+    if (NSystemUtils.isInf(*value)) {
+        NByteVector.pushBack(outVector, 'i');
+        NByteVector.pushBack(outVector, 'n');
+        NByteVector.pushBack(outVector, 'f');
+        return True;
+    }
+    return False;
+}
+
+static inline void appendDoubleToByteVector_Normalize(double* in_out_Value, int32_t* outExponent, const struct FloatToStringConversionSettings* conversionSettings) {
+    double value = *in_out_Value;
+    int32_t exponent=0;
+    if (value >= conversionSettings->upperNormalizationThreshold) {
+        if (value >= 1e256 ) { exponent +=256; value *= 1e-256; }
+        if (value >= 1e128 ) { exponent +=128; value *= 1e-128; }
+        if (value >= 1e64  ) { exponent += 64; value *= 1e-64 ; }
+        if (value >= 1e32  ) { exponent += 32; value *= 1e-32 ; }
+        if (value >= 1e16  ) { exponent += 16; value *= 1e-16 ; }
+        if (value >= 1e8   ) { exponent +=  8; value *= 1e-8  ; }
+        if (value >= 1e4   ) { exponent +=  4; value *= 1e-4  ; }
+        if (value >= 1e2   ) { exponent +=  2; value *= 1e-2  ; }
+        if (value >= 1e1   ) { exponent +=  1; value *= 1e-1  ; }
+    } else if (value <= conversionSettings->lowerNormalizationThreshold) {
+        if (value <  1e-256) { exponent -=256; value *= 1e256 ; }
+        if (value <  1e-128) { exponent -=128; value *= 1e128 ; }
+        if (value <  1e-64 ) { exponent -= 64; value *= 1e64  ; }
+        if (value <  1e-31 ) { exponent -= 32; value *= 1e32  ; }
+        if (value <  1e-15 ) { exponent -= 16; value *= 1e16  ; }
+        if (value <  1e-7  ) { exponent -=  8; value *= 1e8   ; }
+        if (value <  1e-3  ) { exponent -=  4; value *= 1e4   ; }
+        if (value <  1e-1  ) { exponent -=  2; value *= 1e2   ; }
+        if (value <  1     ) { exponent -=  1; value *= 1e1   ; }
+    }
+    *in_out_Value = value;
+    *outExponent = exponent;
+}
+
+static inline void appendDoubleToByteVector_HandleTextFormatting(struct NByteVector *outVector, double value, int32_t exponent, const struct FloatToStringConversionSettings* conversionSettings) {
+    uint64_t integerPart = (uint64_t) value;
+    value -= integerPart;
+    uint64_t fractionPart = (uint64_t) (value * conversionSettings->fractionDigitsShift);
+
+    int32_t lastFractionDigit = fractionPart%10;
+    if (lastFractionDigit > 4) {
+        fractionPart += 10 - lastFractionDigit;
+        if (fractionPart == conversionSettings->fractionDigitsShift) {
+            fractionPart = 0;
+            integerPart++;
+        }
+    } else {
+        fractionPart -= lastFractionDigit;
+    }
+
+    {
+        char integerDigits[FLOAT_TO_STRING_MAX_INTEGER_DIGITS+1];
+        int32_t digitsCount = positiveLongToDigits(integerDigits, integerPart);
+        while (digitsCount--) NByteVector.pushBack(outVector, integerDigits[digitsCount]+48);
+    }
+
+    if (fractionPart) {
+        NByteVector.pushBack(outVector, '.');
+        int32_t digitsCount = 1+conversionSettings->maxFractionDigitsCount;
+        char fractionDigits[FLOAT_TO_STRING_MAX_FRACTION_DIGITS+1];
+        for (int i=digitsCount-1; i; i--) fractionDigits[i] = 0;
+        positiveLongToDigits(fractionDigits, fractionPart);
+
+        int32_t removedZeroesCount=0;
+        while (!fractionDigits[removedZeroesCount]) removedZeroesCount++;
+        digitsCount -= removedZeroesCount;
+        while (digitsCount--) NByteVector.pushBack(outVector, fractionDigits[removedZeroesCount+digitsCount]+48);
+    }
+
+    if (exponent) {
+        NByteVector.pushBack(outVector, 'e');
+        if (exponent < 0) {
+            NByteVector.pushBack(outVector, '-');
+            exponent = 0 - exponent;
+        }
+        char exponentDigits[3];
+        int32_t digitsCount=positiveLongToDigits(exponentDigits, exponent);
+        while (digitsCount--) NByteVector.pushBack(outVector, exponentDigits[digitsCount]+48);
+    }
+}
+
+static void previousAppendDouble(struct NByteVector *outVector, double doubleValue) {
+    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &doubleValue)) return ;
+    int32_t exponent;
+    appendDoubleToByteVector_Normalize(&doubleValue, &exponent, &DEFAULT_DOUBLE_CONVERSION_SETTINGS);
+    appendDoubleToByteVector_HandleTextFormatting(outVector, doubleValue, exponent, &DEFAULT_DOUBLE_CONVERSION_SETTINGS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+/////////////////////////////////////////////////////////////////////////////////////
+
+#define FORMATTER_PREVIOUS      0
+#define FORMATTER_APPEND_DOUBLE 1
+#define FORMATTER_FORMAT        2
+#define FORMATTER_SNPRINTF      3
+
+static double values[VALUES_COUNT];
+
+static double getTimeSeconds() {
+    int64_t seconds, nanos;
+    NSystemUtils.getTime(&seconds, &nanos);
+    return seconds + nanos*1e-9;
+}
+
+static void benchmark(const char* name, int32_t formatter, const char* format) {
+    struct NString string;
+    NString.initialize(&string, "");
+    char buffer[64];
+
+    double bestTime = 1e9;
+    uint64_t charactersCount=0;
+    for (int32_t run=0; run<RUNS_COUNT; run++) {
+        double startTime = getTimeSeconds();
+        charactersCount = 0;
+        for (int32_t i=0; i<VALUES_COUNT; i++) {
+            switch (formatter) {
+                case FORMATTER_PREVIOUS:
+                    string.string.size = 0;
+                    previousAppendDouble(&string.string, values[i]);
+                    charactersCount += string.string.size;
+                    break;
+                case FORMATTER_APPEND_DOUBLE:
+                    NString.set(&string, "");
+                    NString.appendDouble(&string, values[i]);
+                    charactersCount += NString.length(&string);
+                    break;
+                case FORMATTER_FORMAT:
+                    NString.set(&string, format, values[i]);
+                    charactersCount += NString.length(&string);
+                    break;
+                case FORMATTER_SNPRINTF:
+                    charactersCount += snprintf(buffer, sizeof(buffer), format, values[i]);
+                    break;
+            }
+        }
+        double time = getTimeSeconds() - startTime;
+        if (time < bestTime) bestTime = time;
+    }
+    printf("%-26s %6.1f ns/value  %5.1f MB/s\n", name, bestTime*1e9/VALUES_COUNT, charactersCount/bestTime*1e-6);
+
+    // The previous formatter leaves the string unterminated,
+    string.string.size = 0;
+    NString.destroy(&string);
+}
+
+void NMain(int argc, char* argv[]) {
+
+    // Half table-like values with 3 fraction digits, half full precision in [0, 1e6),
+    uint64_t randomState = 12345;
+    for (int32_t i=0; i<VALUES_COUNT; i++) {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 7;
+        randomState ^= randomState << 17;
+        values[i] = (i & 1) ?
+                (double) (randomState % 100000000) / 1000.0 :
+                (double) (randomState >> 11) * 0x1p-53 * 1e6;
+    }
+
+    benchmark("previous %f"             , FORMATTER_PREVIOUS     , 0);
+    benchmark("NString.appendDouble()"  , FORMATTER_APPEND_DOUBLE, 0);
+    benchmark("NString %f"              , FORMATTER_FORMAT       , "%f");
+    benchmark("NString %.3f"            , FORMATTER_FORMAT       , "%.3f");
+    benchmark("NString %e"              , FORMATTER_FORMAT       , "%e");
+    benchmark("NString %g"              , FORMATTER_FORMAT       , "%g");
+    benchmark("snprintf %.17g"          , FORMATTER_SNPRINTF     , "%.17g");
+    benchmark("snprintf %.3f"           , FORMATTER_SNPRINTF     , "%.3f");
+}
@@ -0,0 +1,121 @@
+// Compares the typed vectors of NTypedVector.h against the generic NVector interface, pushing
+// 10,000,000 objects then summing them through get(). Times are the best of several runs. Build
+// with the library sources and a backend:
+//   gcc -O2 -IIncludes *.c Backends/Linux/NSystemUtils.c Benchmarks/NTypedVectorBenchmark.c -o NTypedVectorBenchmark -lm
+
+#include <NTypedVector.h>
+#include <NSystemUtils.h>
+
+#include <stdio.h>
+
+#define OBJECTS_COUNT 10000000
+#define RUNS_COUNT 5
+
+static double getTimeSeconds() {
+    int64_t seconds, nanos;
+    NSystemUtils.getTime(&seconds, &nanos);
+    return seconds + nanos*1e-9;
+}
+
+static void printResult(const char* name, double pushTime, double getTime, int64_t sum) {
+    printf("%-26s push %6.2f ns/object  get %6.2f ns/object  (sum %lld)\n", name, pushTime*1e9/OBJECTS_COUNT, getTime*1e9/OBJECTS_COUNT, (long long) sum);
+}
+
+static void benchmarkGeneric32() {
+    double bestPushTime=1e9, bestGetTime=1e9;
+    int64_t sum=0;
+    for (int32_t run=0; run<RUNS_COUNT; run++) {
+        struct NVector vector;
+        NVector.initialize(&vector, 0, sizeof(int32_t));
+
+        double startTime = getTimeSeconds();
+        for (int32_t i=0; i<OBJECTS_COUNT; i++) NVector.pushBack(&vector, &i);
+        double pushTime = getTimeSeconds() - startTime;
+
+        startTime = getTimeSeconds();
+        sum = 0;
+        for (int32_t i=0; i<OBJECTS_COUNT; i++) sum += *(int32_t*) NVector.get(&vector, i);
+        double getTime = getTimeSeconds() - startTime;
+
+        if (pushTime < bestPushTime) bestPushTime = pushTime;
+        if (getTime < bestGetTime) bestGetTime = getTime;
+        NVector.destroy(&vector);
+    }
+    printResult("NVector (int32_t)", bestPushTime, bestGetTime, sum);
+}
+
+static void benchmarkTyped32() {
+    double bestPushTime=1e9, bestGetTime=1e9;
+    int64_t sum=0;
+    for (int32_t run=0; run<RUNS_COUNT; run++) {
+        struct NVector vector;
+        NVector32_initialize(&vector, 0);
+
+        double startTime = getTimeSeconds();
+        for (int32_t i=0; i<OBJECTS_COUNT; i++) NVector32_pushBack(&vector, i);
+        double pushTime = getTimeSeconds() - startTime;
+
+        startTime = getTimeSeconds();
+        sum = 0;
+        for (int32_t i=0; i<OBJECTS_COUNT; i++) sum += *NVector32_get(&vector, i);
+        double getTime = getTimeSeconds() - startTime;
+
+        if (pushTime < bestPushTime) bestPushTime = pushTime;
+        if (getTime < bestGetTime) bestGetTime = getTime;
+        NVector.destroy(&vector);
+    }
+    printResult("NVector32", bestPushTime, bestGetTime, sum);
+}
+
+static void benchmarkGeneric64() {
+    double bestPushTime=1e9, bestGetTime=1e9;
+    int64_t sum=0;
+    for (int32_t run=0; run<RUNS_COUNT; run++) {
+        struct NVector vector;
+        NVector.initialize(&vector, 0, sizeof(int64_t));
+
+        double startTime = getTimeSeconds();
+        for (int64_t i=0; i<OBJECTS_COUNT; i++) NVector.pushBack(&vector, &i);
+        double pushTime = getTimeSeconds() - startTime;
+
+        startTime = getTimeSeconds();
+        sum = 0;
+        for (int32_t i=0; i<OBJECTS_COUNT; i++) sum += *(int64_t*) NVector.get(&vector, i);
+        double getTime = getTimeSeconds() - startTime;
+
+        if (pushTime < bestPushTime) bestPushTime = pushTime;
+        if (getTime < bestGetTime) bestGetTime = getTime;
+        NVector.destroy(&vector);
+    }
+    printResult("NVector (int64_t)", bestPushTime, bestGetTime, sum);
+}
+
+static void benchmarkTyped64() {
+    double bestPushTime=1e9, bestGetTime=1e9;
+    int64_t sum=0;
+    for (int32_t run=0; run<RUNS_COUNT; run++) {
+        struct NVector vector;
+        NVector64_initialize(&vector, 0);
+
+        double startTime = getTimeSeconds();
+        for (int64_t i=0; i<OBJECTS_COUNT; i++) NVector64_pushBack(&vector, i);
+        double pushTime = getTimeSeconds() - startTime;
+
+        startTime = getTimeSeconds();
+        sum = 0;
+        for (int32_t i=0; i<OBJECTS_COUNT; i++) sum += *NVector64_get(&vector, i);
+        double getTime = getTimeSeconds() - startTime;
+
+        if (pushTime < bestPushTime) bestPushTime = pushTime;
+        if (getTime < bestGetTime) bestGetTime = getTime;
+        NVector.destroy(&vector);
+    }
+    printResult("NVector64", bestPushTime, bestGetTime, sum);
+}
+
+void NMain(int argc, char* argv[]) {
+    benchmarkGeneric32();
+    benchmarkTyped32();
+    benchmarkGeneric64();
+    benchmarkTyped64();
+}
@@ -0,0 +1,77 @@
+// Compares NVector.getFirstInstanceIndex() against a plain memcmp() loop, at every SIMD level,
+// on 1,000,000 objects of 1, 2, 4, 8, 16 and 12 (no kernel) bytes. The searched object is
+// missing, so every search scans the whole vector. Times are the best of several runs.
+//
+// NVector.c is included to force the kernel through simdLevel, so build it without it:
+//   gcc -O2 -IIncludes $(ls *.c | grep -v '^NVector.c$') Backends/Linux/NSystemUtils.c Benchmarks/NVectorSearchBenchmark.c -o NVectorSearchBenchmark -lm
+
+#include "../NVector.c"
+
+// NVector.c has its own remove(),
+#define remove stdioRemove
+#include <stdio.h>
+#undef remove
+
+#define OBJECTS_COUNT 1000000
+
+static double getTimeSeconds() {
+    int64_t seconds, nanos;
+    NSystemUtils.getTime(&seconds, &nanos);
+    return seconds + nanos*1e-9;
+}
+
+static NVectorIndex memcmpLoop(struct NVector* vector, const void* object) {
+    uint8_t* currentObject = vector->objects;
+    for (NVectorSize i=0; i<vector->objectsCount; i++) {
+        if (!NSystemUtils.memcmp(object, currentObject, vector->objectSize)) return i;
+        currentObject += vector->objectSize;
+    }
+    return -1;
+}
+
+void NMain(int argc, char* argv[]) {
+    uint32_t objectSizes[] = {1, 2, 4, 8, 16, 12};
+    for (int32_t sizeIndex=0; sizeIndex<6; sizeIndex++) {
+
+        // Fill with objects that never match the all 0xff object,
+        uint32_t objectSize = objectSizes[sizeIndex];
+        struct NVector vector;
+        NVector.initialize(&vector, OBJECTS_COUNT, objectSize);
+        uint8_t object[16];
+        for (int32_t i=0; i<OBJECTS_COUNT; i++) {
+            for (uint32_t j=0; j<objectSize; j++) object[j] = (uint8_t) ((i*7 + j) % 251);
+            NVector.pushBack(&vector, object);
+        }
+        uint8_t missingObject[16];
+        NSystemUtils.memset(missingObject, 0xff, sizeof(missingObject));
+
+        volatile NVectorIndex result;
+        double bestTime = 1e9;
+        for (int32_t run=0; run<5; run++) {
+            double startTime = getTimeSeconds();
+            result = memcmpLoop(&vector, missingObject);
+            double time = getTimeSeconds() - startTime;
+            if (time < bestTime) bestTime = time;
+        }
+        printf("size %2u  memcmp loop %7.3f ms", objectSize, bestTime*1e3);
+
+        const char* levelNames[] = {"scalar", "sse2", "avx2"};
+        int32_t maxLevel = getSIMDLevel();
+        for (int32_t level=0; level<=maxLevel; level++) {
+            simdLevel = level;
+            bestTime = 1e9;
+            for (int32_t run=0; run<20; run++) {
+                double startTime = getTimeSeconds();
+                result = getFirstInstanceIndex(&vector, missingObject);
+                double time = getTimeSeconds() - startTime;
+                if (time < bestTime) bestTime = time;
+            }
+            printf("  %s %7.3f ms", levelNames[level], bestTime*1e3);
+        }
+        simdLevel = -1;
+        printf("\n");
+
+        (void) result;
+        NVector.destroy(&vector);
+    }
+}
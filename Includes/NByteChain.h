@@ -0,0 +1,65 @@
+// A chain of byte segments. Appending fills the last segment, then links a new one, so existing
+// data is never copied (unlike NByteVector, which copies everything when it grows). Whole chains
+// can be spliced in O(1), and written to a file in one gathering system call.
+//
+// Suits building large outputs (logs, serialized data) piece by piece. To iterate the contents,
+// follow the segments from firstSegment (read only).
+
+#pragma once
+
+#include <NTypes.h>
+#include <NByteVector.h>
+
+#define NBYTECHAIN_DEFAULT_SEGMENT_CAPACITY 4096
+
+struct NByteChainSegment {
+    struct NByteChainSegment* next;
+    NVectorSize size;
+    NVectorSize capacity;
+    uint8_t data[];
+};
+
+struct NByteChain {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    struct NByteChainSegment* firstSegment;
+    struct NByteChainSegment* lastSegment;
+    NVectorSize size;
+    NVectorSize segmentsCount;
+    NVectorSize segmentCapacity;
+};
+
+struct NByteChain_Interface {
+    struct NByteChain* (*initialize)(struct NByteChain* outputChain, NVectorSize segmentCapacity); // 0 for the default capacity.
+    struct NByteChain* (*create)(NVectorSize segmentCapacity);
+    void (*destroy)(struct NByteChain* chain);
+    void (*destroyAndFree)(struct NByteChain* chain);
+    struct NByteChain* (*clear)(struct NByteChain* chain); // Frees all segments.
+    boolean (*pushBack)(struct NByteChain* chain, uint8_t value); // True if successful.
+    boolean (*pushBackBulk)(struct NByteChain* chain, const void* data, NVectorSize size); // Can span several segments. True if successful.
+    void* (*reserveWritable)(struct NByteChain* chain, NVectorSize size); // Contiguous space at the end (a new segment is linked if needed). 0 if failed.
+    boolean (*commit)(struct NByteChain* chain, NVectorSize writtenSize); // Appends the bytes written into the reserved space. True if successful.
+    struct NByteChain* (*splice)(struct NByteChain* chain, struct NByteChain* chainToAppend); // O(1). Moves all segments of chainToAppend, leaving it empty. Does nothing if both are the same chain.
+    NVectorSize (*size)(struct NByteChain* chain);
+    NVectorSize (*segmentsCount)(struct NByteChain* chain);
+    boolean (*appendToByteVector)(struct NByteChain* chain, struct NByteVector* outputVector); // Copies the contents. True if successful.
+    boolean (*writeToFile)(struct NByteChain* chain, const char* filePath, boolean append); // Returns success.
+};
+
+extern const struct NByteChain_Interface NByteChain;
+
+#if NSTDLIB_INLINE
+
+static inline boolean NByteChain_pushBack(struct NByteChain* chain, uint8_t value) {
+
+    // Fast path, room in the last segment,
+    struct NByteChainSegment* segment = chain->lastSegment;
+    if (segment && (segment->size < segment->capacity)) {
+        segment->data[segment->size++] = value;
+        chain->size++;
+        return True;
+    }
+
+    return NByteChain.pushBackBulk(chain, &value, 1);
+}
+
+#endif
@@ -0,0 +1,119 @@
+// A cursor for parsing bytes front to back, over an NByteVector or any memory. It doesn't copy nor
+// allocate anything, reading is a bounds check and a pointer bump. All reads return False (without
+// consuming anything) if not enough bytes remain.
+//
+// Multi-byte values are little-endian, unless suffixed with BE (big-endian). Varints are decoded as
+// in NVarint.
+//
+// Example:
+//    struct NByteReader reader;
+//    NByteReader.initializeFromVector(&reader, &message);
+//    uint16_t type; uint64_t length; const void* payload;
+//    if (!NByteReader.readU16(&reader, &type) ||
+//        !NByteReader.readVarint(&reader, &length) ||
+//        !NByteReader.readBytes(&reader, length, &payload)) { /* Malformed message. */ }
+
+#pragma once
+
+#include <NTypes.h>
+#include <NByteVector.h>
+#include <NVarint.h>
+
+struct NByteReader {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    const uint8_t* start;
+    const uint8_t* current;
+    const uint8_t* end;
+};
+
+struct NByteReader_Interface {
+    struct NByteReader* (*initialize)(struct NByteReader* outputReader, const void* data, NVectorSize dataSize);
+    struct NByteReader* (*initializeFromVector)(struct NByteReader* outputReader, struct NByteVector* vector); // The vector must not be modified while reading.
+
+    NVectorSize (*remaining)(struct NByteReader* reader);
+    NVectorSize (*position)(struct NByteReader* reader); // Bytes consumed so far.
+    boolean (*skip)(struct NByteReader* reader, NVectorSize size);
+
+    boolean (*readU8 )(struct NByteReader* reader, uint8_t * output);
+    boolean (*readU16)(struct NByteReader* reader, uint16_t* output);
+    boolean (*readU32)(struct NByteReader* reader, uint32_t* output);
+    boolean (*readU64)(struct NByteReader* reader, uint64_t* output);
+    boolean (*readFloat )(struct NByteReader* reader, float * output);
+    boolean (*readDouble)(struct NByteReader* reader, double* output);
+    boolean (*readU16BE)(struct NByteReader* reader, uint16_t* output);
+    boolean (*readU32BE)(struct NByteReader* reader, uint32_t* output);
+    boolean (*readU64BE)(struct NByteReader* reader, uint64_t* output);
+    boolean (*readFloatBE )(struct NByteReader* reader, float * output);
+    boolean (*readDoubleBE)(struct NByteReader* reader, double* output);
+    boolean (*readVarint)(struct NByteReader* reader, uint64_t* output);
+    boolean (*readSignedVarint)(struct NByteReader* reader, int64_t* output); // Zigzag encoded.
+    boolean (*readBytes)(struct NByteReader* reader, NVectorSize size, const void** outputView); // The view points into the read data.
+
+    boolean (*peekU8)(struct NByteReader* reader, uint8_t* output);
+    boolean (*peekBytes)(struct NByteReader* reader, NVectorSize size, const void** outputView);
+};
+
+extern const struct NByteReader_Interface NByteReader;
+
+#if NSTDLIB_INLINE
+
+static inline NVectorSize NByteReader_remaining(struct NByteReader* reader) {
+    return (NVectorSize) (reader->end - reader->current);
+}
+
+static inline boolean NByteReader_skip(struct NByteReader* reader, NVectorSize size) {
+    if (size > NByteReader_remaining(reader)) return False;
+    reader->current += size;
+    return True;
+}
+
+static inline boolean NByteReader_readU8(struct NByteReader* reader, uint8_t* output) {
+    if (reader->current == reader->end) return False;
+    *output = *reader->current++;
+    return True;
+}
+
+#define NBYTEREADER_DEFINE_READ(Name, Type, BitsType, swap) \
+    static inline boolean NByteReader_read##Name(struct NByteReader* reader, Type* output) { \
+        if (NByteReader_remaining(reader) < sizeof(Type)) return False; \
+        BitsType bits; \
+        NSTDLIB_INLINE_MEMCPY(&bits, reader->current, sizeof(Type)); \
+        bits = swap(bits); \
+        NSTDLIB_INLINE_MEMCPY(output, &bits, sizeof(Type)); \
+        reader->current += sizeof(Type); \
+        return True; \
+    }
+
+NBYTEREADER_DEFINE_READ(U16   , uint16_t, uint16_t, NBYTEVECTOR_LE_SWAP16)
+NBYTEREADER_DEFINE_READ(U32   , uint32_t, uint32_t, NBYTEVECTOR_LE_SWAP32)
+NBYTEREADER_DEFINE_READ(U64   , uint64_t, uint64_t, NBYTEVECTOR_LE_SWAP64)
+NBYTEREADER_DEFINE_READ(Float , float   , uint32_t, NBYTEVECTOR_LE_SWAP32)
+NBYTEREADER_DEFINE_READ(Double, double  , uint64_t, NBYTEVECTOR_LE_SWAP64)
+
+NBYTEREADER_DEFINE_READ(U16BE   , uint16_t, uint16_t, NBYTEVECTOR_BE_SWAP16)
+NBYTEREADER_DEFINE_READ(U32BE   , uint32_t, uint32_t, NBYTEVECTOR_BE_SWAP32)
+NBYTEREADER_DEFINE_READ(U64BE   , uint64_t, uint64_t, NBYTEVECTOR_BE_SWAP64)
+NBYTEREADER_DEFINE_READ(FloatBE , float   , uint32_t, NBYTEVECTOR_BE_SWAP32)
+NBYTEREADER_DEFINE_READ(DoubleBE, double  , uint64_t, NBYTEVECTOR_BE_SWAP64)
+
+static inline boolean NByteReader_readVarint(struct NByteReader* reader, uint64_t* output) {
+
+    // Single byte values are the common case,
+    if ((reader->current != reader->end) && !(*reader->current & 0x80)) {
+        *output = *reader->current++;
+        return True;
+    }
+
+    NVectorSize length = NVarint.decode(reader->current, NByteReader_remaining(reader), output);
+    reader->current += length;
+    return length ? True : False;
+}
+
+static inline boolean NByteReader_readBytes(struct NByteReader* reader, NVectorSize size, const void** outputView) {
+    if (size > NByteReader_remaining(reader)) return False;
+    *outputView = reader->current;
+    reader->current += size;
+    return True;
+}
+
+#endif
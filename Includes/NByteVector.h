@@ -6,17 +6,31 @@
 #pragma once
 
 #include <NTypes.h>
+#include <NGrowthPolicy.h>
+
+#ifndef NBYTEVECTOR_BOUNDARY_CHECK
+    #define NBYTEVECTOR_BOUNDARY_CHECK 1
+#endif
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    #define NBYTEVECTOR_BIG_ENDIAN_HOST 1
+#else
+    #define NBYTEVECTOR_BIG_ENDIAN_HOST 0
+#endif
 
 struct NByteVector {
     // DON'T OVERWRITE. For use by the provided functions only.
-    uint32_t capacity;
-    uint32_t size;
+    NVectorSize capacity;
+    NVectorSize size;
     uint8_t* objects;
+    int32_t growthPolicy;  // One of NGrowthPolicy values. Appended, to keep the original layout.
+    boolean externalObjects; // True while objects is a buffer provided by the user. It's never freed nor
+                             // reallocated, the objects are copied to a new allocation once outgrown.
 };
 
 struct NByteVector_Interface {
-    struct NByteVector* (*initialize)(struct NByteVector* outputVector, uint32_t initialCapacity);
-    struct NByteVector* (*create)(uint32_t initialCapacity);
+    struct NByteVector* (*initialize)(struct NByteVector* outputVector, NVectorSize initialCapacity);
+    struct NByteVector* (*create)(NVectorSize initialCapacity);
     void (*destroy)(struct NByteVector* vector);
     void (*destroyAndFree)(struct NByteVector* vector);
     struct NByteVector* (*clear)(struct NByteVector* vector);
@@ -24,13 +38,188 @@ struct NByteVector_Interface {
     boolean (*popBack)(struct NByteVector* vector, uint8_t* output);   // True if successful.
     boolean (*pushBack32Bit)(struct NByteVector* vector, int32_t value);
     boolean (*popBack32Bit)(struct NByteVector* vector, int32_t *output);
-    boolean (*pushBackBulk)(struct NByteVector* vector, void* data, uint32_t size);
-    boolean (*popBackBulk)(struct NByteVector* vector, void* outputData, uint32_t size);
-    uint8_t (*get)(struct NByteVector* vector, uint32_t index);
-    boolean (*set)(struct NByteVector* vector, uint32_t index, uint8_t value);
-    uint32_t (*size)(struct NByteVector* vector);
-    boolean (*resize)(struct NByteVector* vector, uint32_t newSize);
-    boolean (*ensureCapacity)(struct NByteVector* vector, uint32_t additionalCapacity);
+    boolean (*pushBackBulk)(struct NByteVector* vector, void* data, NVectorSize size);
+    boolean (*popBackBulk)(struct NByteVector* vector, void* outputData, NVectorSize size);
+    uint8_t (*get)(struct NByteVector* vector, NVectorSize index);
+    boolean (*set)(struct NByteVector* vector, NVectorSize index, uint8_t value);
+    NVectorSize (*size)(struct NByteVector* vector);
+    boolean (*resize)(struct NByteVector* vector, NVectorSize newSize);
+    boolean (*ensureCapacity)(struct NByteVector* vector, NVectorSize additionalCapacity);
+
+    struct NByteVector* (*setGrowthPolicy)(struct NByteVector* vector, int32_t growthPolicy); // Returns vector. Call right after initializing.
+    struct NByteVector* (*initializeWithBuffer)(struct NByteVector* outputVector, void* buffer, NVectorSize bufferSize); // Uses buffer (e.g., on the stack) until outgrown.
+
+    // Multi-byte values, in the host byte order. Values needn't be aligned. Peek functions read the
+    // last value without popping it. See NByteVectorLE and NByteVectorBE for explicit byte orders,
+    boolean (*pushBack16Bit)(struct NByteVector* vector, int16_t value);
+    boolean (*popBack16Bit)(struct NByteVector* vector, int16_t *output);
+    boolean (*peek16Bit)(struct NByteVector* vector, int16_t *output);
+    boolean (*peek32Bit)(struct NByteVector* vector, int32_t *output);
+    boolean (*pushBack64Bit)(struct NByteVector* vector, int64_t value);
+    boolean (*popBack64Bit)(struct NByteVector* vector, int64_t *output);
+    boolean (*peek64Bit)(struct NByteVector* vector, int64_t *output);
+    boolean (*pushBackFloat)(struct NByteVector* vector, float value);
+    boolean (*popBackFloat)(struct NByteVector* vector, float *output);
+    boolean (*peekFloat)(struct NByteVector* vector, float *output);
+    boolean (*pushBackDouble)(struct NByteVector* vector, double value);
+    boolean (*popBackDouble)(struct NByteVector* vector, double *output);
+    boolean (*peekDouble)(struct NByteVector* vector, double *output);
+
+    // Zero-copy filling. reserveWritable() returns a pointer to at least size writable bytes past the
+    // end (0 if failed), which producers (fread, decoders...) can write into directly. commit() then
+    // appends the written bytes (up to the reserved size),
+    void* (*reserveWritable)(struct NByteVector* vector, NVectorSize size);
+    boolean (*commit)(struct NByteVector* vector, NVectorSize writtenSize); // True if successful.
 };
 
 extern const struct NByteVector_Interface NByteVector;
+
+// Same as the multi-byte functions of NByteVector, in a fixed byte order. Use these for data that
+// leaves the process (files, network messages),
+struct NByteVectorEndian_Interface {
+    boolean (*pushBack16Bit)(struct NByteVector* vector, int16_t value);
+    boolean (*popBack16Bit)(struct NByteVector* vector, int16_t *output);
+    boolean (*peek16Bit)(struct NByteVector* vector, int16_t *output);
+    boolean (*pushBack32Bit)(struct NByteVector* vector, int32_t value);
+    boolean (*popBack32Bit)(struct NByteVector* vector, int32_t *output);
+    boolean (*peek32Bit)(struct NByteVector* vector, int32_t *output);
+    boolean (*pushBack64Bit)(struct NByteVector* vector, int64_t value);
+    boolean (*popBack64Bit)(struct NByteVector* vector, int64_t *output);
+    boolean (*peek64Bit)(struct NByteVector* vector, int64_t *output);
+    boolean (*pushBackFloat)(struct NByteVector* vector, float value);
+    boolean (*popBackFloat)(struct NByteVector* vector, float *output);
+    boolean (*peekFloat)(struct NByteVector* vector, float *output);
+    boolean (*pushBackDouble)(struct NByteVector* vector, double value);
+    boolean (*popBackDouble)(struct NByteVector* vector, double *output);
+    boolean (*peekDouble)(struct NByteVector* vector, double *output);
+};
+
+extern const struct NByteVectorEndian_Interface NByteVectorLE; // Little-endian.
+extern const struct NByteVectorEndian_Interface NByteVectorBE; // Big-endian (network byte order).
+
+#if NSTDLIB_INLINE
+
+static inline boolean NByteVector_pushBack(struct NByteVector* vector, uint8_t value) {
+
+    // Expand the vector capacity if needed,
+    if ((vector->size == vector->capacity) && !NByteVector.ensureCapacity(vector, 1)) return False;
+
+    // Push the value,
+    vector->objects[vector->size++] = value;
+    return True;
+}
+
+static inline boolean NByteVector_popBack(struct NByteVector* vector, uint8_t *output) {
+    if (vector->size == 0) return False;
+
+    *output = vector->objects[--(vector->size)];
+    return True;
+}
+
+static inline boolean NByteVector_pushBackBulk(struct NByteVector* vector, const void* data, NVectorSize size) {
+
+    // Increase capacity if needed (written so that a huge size can't wrap around),
+    if ((size > vector->capacity - vector->size) && !NByteVector.ensureCapacity(vector, size)) return False;
+
+    // Push the block,
+    NSTDLIB_INLINE_MEMCPY(&vector->objects[vector->size], data, size);
+    vector->size += size;
+    return True;
+}
+
+static inline uint8_t NByteVector_get(struct NByteVector* vector, NVectorSize index) {
+    #if NBYTEVECTOR_BOUNDARY_CHECK
+    if (index >= vector->size) return NByteVector.get(vector, index); // Reports the error.
+    #endif
+
+    return vector->objects[index];
+}
+
+static inline boolean NByteVector_set(struct NByteVector* vector, NVectorSize index, uint8_t value) {
+    #if NBYTEVECTOR_BOUNDARY_CHECK
+    if (index >= vector->size) return NByteVector.set(vector, index, value); // Reports the error.
+    #endif
+
+    vector->objects[index] = value;
+    return True;
+}
+
+static inline NVectorSize NByteVector_size(struct NByteVector* vector) {
+    return vector->size;
+}
+
+static inline void* NByteVector_reserveWritable(struct NByteVector* vector, NVectorSize size) {
+    if ((size > vector->capacity - vector->size) && !NByteVector.ensureCapacity(vector, size)) return 0;
+    return &vector->objects[vector->size];
+}
+
+static inline boolean NByteVector_commit(struct NByteVector* vector, NVectorSize writtenSize) {
+    if (writtenSize > vector->capacity - vector->size) return False;
+    vector->size += writtenSize;
+    return True;
+}
+
+// Multi-byte values are copied through memcpy, which is safe for unaligned addresses and compiles
+// to a single load/store (plus a byte swap when the byte order differs from the host's),
+#define NBYTEVECTOR_NO_SWAP(value) (value)
+#if NBYTEVECTOR_BIG_ENDIAN_HOST
+    #define NBYTEVECTOR_LE_SWAP16 __builtin_bswap16
+    #define NBYTEVECTOR_LE_SWAP32 __builtin_bswap32
+    #define NBYTEVECTOR_LE_SWAP64 __builtin_bswap64
+    #define NBYTEVECTOR_BE_SWAP16 NBYTEVECTOR_NO_SWAP
+    #define NBYTEVECTOR_BE_SWAP32 NBYTEVECTOR_NO_SWAP
+    #define NBYTEVECTOR_BE_SWAP64 NBYTEVECTOR_NO_SWAP
+#else
+    #define NBYTEVECTOR_LE_SWAP16 NBYTEVECTOR_NO_SWAP
+    #define NBYTEVECTOR_LE_SWAP32 NBYTEVECTOR_NO_SWAP
+    #define NBYTEVECTOR_LE_SWAP64 NBYTEVECTOR_NO_SWAP
+    #define NBYTEVECTOR_BE_SWAP16 __builtin_bswap16
+    #define NBYTEVECTOR_BE_SWAP32 __builtin_bswap32
+    #define NBYTEVECTOR_BE_SWAP64 __builtin_bswap64
+#endif
+
+#define NBYTEVECTOR_DEFINE_TYPED(Name, Type, BitsType, swap) \
+    static inline boolean NByteVector_pushBack##Name(struct NByteVector* vector, Type value) { \
+        if ((sizeof(Type) > vector->capacity - vector->size) && !NByteVector.ensureCapacity(vector, sizeof(Type))) return False; \
+        BitsType bits; \
+        NSTDLIB_INLINE_MEMCPY(&bits, &value, sizeof(Type)); \
+        bits = swap(bits); \
+        NSTDLIB_INLINE_MEMCPY(&vector->objects[vector->size], &bits, sizeof(Type)); \
+        vector->size += sizeof(Type); \
+        return True; \
+    } \
+    \
+    static inline boolean NByteVector_peek##Name(struct NByteVector* vector, Type* output) { \
+        if (vector->size < sizeof(Type)) return False; \
+        BitsType bits; \
+        NSTDLIB_INLINE_MEMCPY(&bits, &vector->objects[vector->size - sizeof(Type)], sizeof(Type)); \
+        bits = swap(bits); \
+        NSTDLIB_INLINE_MEMCPY(output, &bits, sizeof(Type)); \
+        return True; \
+    } \
+    \
+    static inline boolean NByteVector_popBack##Name(struct NByteVector* vector, Type* output) { \
+        if (!NByteVector_peek##Name(vector, output)) return False; \
+        vector->size -= sizeof(Type); \
+        return True; \
+    }
+
+NBYTEVECTOR_DEFINE_TYPED(16Bit, int16_t, uint16_t, NBYTEVECTOR_NO_SWAP)
+NBYTEVECTOR_DEFINE_TYPED(32Bit, int32_t, uint32_t, NBYTEVECTOR_NO_SWAP)
+NBYTEVECTOR_DEFINE_TYPED(64Bit, int64_t, uint64_t, NBYTEVECTOR_NO_SWAP)
+NBYTEVECTOR_DEFINE_TYPED(Float , float , uint32_t, NBYTEVECTOR_NO_SWAP)
+NBYTEVECTOR_DEFINE_TYPED(Double, double, uint64_t, NBYTEVECTOR_NO_SWAP)
+
+NBYTEVECTOR_DEFINE_TYPED(16BitLE, int16_t, uint16_t, NBYTEVECTOR_LE_SWAP16)
+NBYTEVECTOR_DEFINE_TYPED(32BitLE, int32_t, uint32_t, NBYTEVECTOR_LE_SWAP32)
+NBYTEVECTOR_DEFINE_TYPED(64BitLE, int64_t, uint64_t, NBYTEVECTOR_LE_SWAP64)
+NBYTEVECTOR_DEFINE_TYPED(FloatLE , float , uint32_t, NBYTEVECTOR_LE_SWAP32)
+NBYTEVECTOR_DEFINE_TYPED(DoubleLE, double, uint64_t, NBYTEVECTOR_LE_SWAP64)
+
+NBYTEVECTOR_DEFINE_TYPED(16BitBE, int16_t, uint16_t, NBYTEVECTOR_BE_SWAP16)
+NBYTEVECTOR_DEFINE_TYPED(32BitBE, int32_t, uint32_t, NBYTEVECTOR_BE_SWAP32)
+NBYTEVECTOR_DEFINE_TYPED(64BitBE, int64_t, uint64_t, NBYTEVECTOR_BE_SWAP64)
+NBYTEVECTOR_DEFINE_TYPED(FloatBE , float , uint32_t, NBYTEVECTOR_BE_SWAP32)
+NBYTEVECTOR_DEFINE_TYPED(DoubleBE, double, uint64_t, NBYTEVECTOR_BE_SWAP64)
+
+#endif
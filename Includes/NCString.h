@@ -7,6 +7,11 @@
 
 #include <NTypes.h>
 
+// parseFloat() and parseDouble() results,
+#define NCSTRING_PARSE_OK           0
+#define NCSTRING_PARSE_INVALID      1 // No number at the start of the string. The output is 0.
+#define NCSTRING_PARSE_OUT_OF_RANGE 2 // Non-zero, but rounded to 0 or infinity (which is the output).
+
 struct NCString_Interface {
     int32_t (*length)(const char* string);
     boolean (*startsWith)(const char* string, const char* value);
@@ -18,6 +23,48 @@ struct NCString_Interface {
     char* (*clone)(const char* source);
     int32_t (*parseInteger)(const char* string);
     int64_t (*parse64BitInteger)(const char* string);
+    int32_t (*compare)(const char* string, const char* value); // Lexicographic. Negative, zero or positive if string is less than, equal to or greater than value.
+
+    // Parses [+-]digits[.digits][(e|E)[+-]digits], inf, infinity or nan (case insensitive), from the
+    // start of the string, correctly rounded. Locale independent, the decimal point is always '.'.
+    // Doesn't skip white spaces nor push errors. Sets outEnd (if not 0) to the first character
+    // after the number (string if invalid). Returns one of the NCSTRING_PARSE_ results,
+    int32_t (*parseFloat )(const char* string, float * outValue, const char** outEnd);
+    int32_t (*parseDouble)(const char* string, double* outValue, const char** outEnd);
 };
 
 extern const struct NCString_Interface NCString;
+
+#if NSTDLIB_INLINE
+
+static inline int32_t NCString_length(const char* string) {
+    int32_t length=0;
+    while (string[length]) length++;
+    return length;
+}
+
+static inline boolean NCString_startsWith(const char* string, const char* value) {
+
+    int32_t index=0;
+    while (string[index] && value[index]) {
+        if (string[index] != value[index]) return False;
+        index++;
+    }
+
+    // Check if loop ended because string ended while value didn't,
+    return value[index] ? False : True;
+}
+
+static inline boolean NCString_equals(const char* string, const char* value) {
+
+    int32_t index=0;
+    while (string[index] && value[index]) {
+        if (string[index] != value[index]) return False;
+        index++;
+    }
+
+    // Check if the loop ended while either of the two strings didn't reach the end yet,
+    return (string[index] || value[index]) ? False : True;
+}
+
+#endif
@@ -0,0 +1,81 @@
+// A double-ended queue over a ring buffer. Objects can be pushed and popped at both ends in O(1),
+// which makes it a good FIFO (unlike NVector, where removing the first object moves all others).
+// The capacity is always a power of 2, so that wrapping indices around is a mere mask.
+
+#pragma once
+
+#include <NTypes.h>
+
+#ifndef NDEQUE_BOUNDARY_CHECK
+    #define NDEQUE_BOUNDARY_CHECK 1
+#endif
+
+struct NDeque {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    NVectorSize capacity;     // 0 or a power of 2.
+    NVectorSize head;         // Index of the first object in objects.
+    NVectorSize objectsCount;
+    uint32_t objectSize;
+    void* objects;
+};
+
+struct NDeque_Interface {
+    struct NDeque* (*initialize)(struct NDeque* outputDeque, NVectorSize initialCapacity, uint32_t objectSize); // initialCapacity is rounded up to a power of 2.
+    struct NDeque* (*create)(NVectorSize initialCapacity, uint32_t objectSize);
+    void (*destroy)(struct NDeque* deque);
+    void (*destroyAndFree)(struct NDeque* deque);
+    struct NDeque* (*clear)(struct NDeque* deque);
+    boolean (*ensureCapacity)(struct NDeque* deque, NVectorSize additionalCapacity);
+    boolean (*pushBack)(struct NDeque* deque, const void* object);  // True if successful.
+    boolean (*pushFront)(struct NDeque* deque, const void* object); // True if successful.
+    boolean (*popBack)(struct NDeque* deque, void* outputObject);   // True if successful.
+    boolean (*popFront)(struct NDeque* deque, void* outputObject);  // True if successful.
+    boolean (*pushBackBulk)(struct NDeque* deque, const void* objects, NVectorSize objectsCount); // True if successful.
+    boolean (*popFrontBulk)(struct NDeque* deque, void* outputObjects, NVectorSize objectsCount); // True if successful.
+    void* (*get)(struct NDeque* deque, NVectorSize index); // Index 0 is the front.
+    void* (*getFirst)(struct NDeque* deque);
+    void* (*getLast)(struct NDeque* deque);
+    NVectorSize (*size)(struct NDeque* deque);
+};
+
+extern const struct NDeque_Interface NDeque;
+
+#if NSTDLIB_INLINE
+
+static inline void* NDeque_getAddress(struct NDeque* deque, NVectorSize index) {
+    NVectorSize physicalIndex = (deque->head + index) & (deque->capacity - 1);
+    return (void *)(((intptr_t) deque->objects) + (physicalIndex * deque->objectSize));
+}
+
+static inline boolean NDeque_pushBack(struct NDeque* deque, const void* object) {
+
+    // Expand the deque capacity if needed,
+    if ((deque->objectsCount == deque->capacity) && !NDeque.ensureCapacity(deque, 1)) return False;
+
+    NSTDLIB_INLINE_MEMCPY(NDeque_getAddress(deque, deque->objectsCount), object, deque->objectSize);
+    deque->objectsCount++;
+    return True;
+}
+
+static inline boolean NDeque_popFront(struct NDeque* deque, void* outputObject) {
+    if (deque->objectsCount==0) return False;
+
+    NSTDLIB_INLINE_MEMCPY(outputObject, NDeque_getAddress(deque, 0), deque->objectSize);
+    deque->head = (deque->head + 1) & (deque->capacity - 1);
+    deque->objectsCount--;
+    return True;
+}
+
+static inline void* NDeque_get(struct NDeque* deque, NVectorSize index) {
+    #if NDEQUE_BOUNDARY_CHECK
+    if (index >= deque->objectsCount) return 0;
+    #endif
+
+    return NDeque_getAddress(deque, index);
+}
+
+static inline NVectorSize NDeque_size(struct NDeque* deque) {
+    return deque->objectsCount;
+}
+
+#endif
@@ -0,0 +1,32 @@
+// Binary to text encodings, for embedding binary data in logs, configuration files, etc.
+//
+// Hex encoding emits lowercase digits. Decoding accepts both cases.
+//
+// Base64 follows RFC 4648. The standard alphabet uses '+' and '/' and pads the output with '='.
+// The URL-safe alphabet uses '-' and '_' and doesn't pad. Decoding accepts the padding either way.
+//
+// Encoding appends to the output string, and decoding appends to the output vector. The output
+// size is reserved up front. If decoding fails (invalid character or length) an error is reported
+// and the output is left unchanged.
+
+#pragma once
+
+#include <NTypes.h>
+#include <NByteVector.h>
+#include <NString.h>
+
+struct NEncoding_Interface {
+    NVectorSize (*hexEncodedSize)(NVectorSize size);
+    boolean (*hexEncode)(const void* data, NVectorSize size, struct NString* outString); // True if successful.
+    boolean (*hexEncodeByteVector)(struct NByteVector* vector, struct NString* outString); // True if successful.
+    boolean (*hexDecode)(const char* text, NVectorSize length, struct NByteVector* output); // True if successful.
+    boolean (*hexDecodeString)(struct NString* string, struct NByteVector* output); // True if successful.
+
+    NVectorSize (*base64EncodedSize)(NVectorSize size, boolean urlSafe);
+    boolean (*base64Encode)(const void* data, NVectorSize size, struct NString* outString, boolean urlSafe); // True if successful.
+    boolean (*base64EncodeByteVector)(struct NByteVector* vector, struct NString* outString, boolean urlSafe); // True if successful.
+    boolean (*base64Decode)(const char* text, NVectorSize length, struct NByteVector* output, boolean urlSafe); // True if successful.
+    boolean (*base64DecodeString)(struct NString* string, struct NByteVector* output, boolean urlSafe); // True if successful.
+};
+
+extern const struct NEncoding_Interface NEncoding;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <NTypes.h>
+
+#define NGROWTH_POLICY_PAGE_SIZE 4096
+
+struct NGrowthPolicy {
+    const int32_t DOUBLE;          // Default. Capacity doubles with every expansion.
+    const int32_t ONE_AND_A_HALF;  // Capacity grows by 50%. Less slack, more expansions.
+    const int32_t EXACT;           // Grows to exactly the required capacity. Use when the final size is known.
+    const int32_t PAGE_ROUNDED;    // Grows by 50%, rounded up to whole pages. Suits large buffers, which the
+                                   // allocator can then remap in place.
+
+    // Returns the capacity to grow to in order to fit requiredCapacity objects, 0 if not possible,
+    NVectorSize (*getNewCapacity)(int32_t growthPolicy, NVectorSize currentCapacity, NVectorSize requiredCapacity, uint32_t objectSize);
+};
+
+extern const struct NGrowthPolicy NGrowthPolicy;
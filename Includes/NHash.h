@@ -0,0 +1,39 @@
+// Non-cryptographic hashing and checksums:
+//  - xxh64: XXH64 (xxHash, 64bit). Fast, well distributed. Suits hash tables and deduplication.
+//  - crc32c: CRC-32C (Castagnoli). Suits integrity checks. Uses the SSE4.2 crc32 instruction when
+//    available, and a table driven (slicing-by-8) implementation otherwise.
+//
+// Both have one-shot functions over raw memory, NByteVectors and NStrings, and streaming functions
+// for data that arrives in pieces. Streaming gives the same results as one-shot hashing of all the
+// pieces concatenated.
+
+#pragma once
+
+#include <NTypes.h>
+#include <NByteVector.h>
+#include <NString.h>
+
+struct NHashXXH64State {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    uint64_t accumulators[4];
+    uint64_t seed;
+    uint64_t totalSize;
+    uint8_t buffer[32];
+    uint32_t bufferSize;
+};
+
+struct NHash_Interface {
+    uint64_t (*xxh64)(const void* data, NVectorSize size, uint64_t seed);
+    uint64_t (*xxh64ByteVector)(struct NByteVector* vector, uint64_t seed);
+    uint64_t (*xxh64String)(struct NString* string, uint64_t seed); // Excludes the termination zero.
+    void (*xxh64Initialize)(struct NHashXXH64State* state, uint64_t seed);
+    void (*xxh64Update)(struct NHashXXH64State* state, const void* data, NVectorSize size);
+    uint64_t (*xxh64Finalize)(struct NHashXXH64State* state); // Doesn't modify the state, more data can still be added.
+
+    uint32_t (*crc32c)(const void* data, NVectorSize size);
+    uint32_t (*crc32cByteVector)(struct NByteVector* vector);
+    uint32_t (*crc32cString)(struct NString* string); // Excludes the termination zero.
+    uint32_t (*crc32cUpdate)(uint32_t crc, const void* data, NVectorSize size); // Streaming. Start with a crc of 0, pass the returned crc with the next piece.
+};
+
+extern const struct NHash_Interface NHash;
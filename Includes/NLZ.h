@@ -0,0 +1,33 @@
+// Fast LZ77 compression, using the LZ4 block encoding (sequences of literals and matches, with
+// 64KB offsets). Trades compression ratio for speed, decompression runs at memory speeds.
+//
+// Block format:
+//   varint header: (uncompressedSize << 1) | isStored
+//   payload: the LZ4 encoded sequences, or the data as is if isStored (incompressible data).
+//
+// Frame format, for data produced or consumed in pieces:
+//   "NLZF" magic, then blocks (of up to NLZ_FRAME_BLOCK_SIZE uncompressed bytes each) every one
+//   preceded by its varint encoded size, then a 0 (end marker). Blocks are independent.
+//
+// All functions append to the output vector. Decompression validates the input, and reports an
+// error (returning 0/False) if it's corrupt.
+
+#pragma once
+
+#include <NTypes.h>
+#include <NByteVector.h>
+
+#define NLZ_FRAME_BLOCK_SIZE (64*1024)
+
+struct NLZ_Interface {
+    NVectorSize (*compressBound)(NVectorSize size); // Maximum size of a compressed block.
+    boolean (*compress)(const void* data, NVectorSize size, struct NByteVector* output); // Appends a block. True if successful.
+    boolean (*decompress)(const void* data, NVectorSize size, struct NByteVector* output); // Data must be exactly one block. True if successful.
+
+    boolean (*beginFrame)(struct NByteVector* output);
+    boolean (*compressToFrame)(const void* data, NVectorSize size, struct NByteVector* output); // Can be called any number of times between beginFrame() and endFrame().
+    boolean (*endFrame)(struct NByteVector* output);
+    NVectorSize (*decompressFrame)(const void* data, NVectorSize size, struct NByteVector* output); // Frames are self delimiting. Returns the consumed size, 0 if failed.
+};
+
+extern const struct NLZ_Interface NLZ;
@@ -8,6 +8,7 @@
 #include <NTypes.h>
 
 void NMemoryProfiler_initialize();
-void* NMemoryProfiler_malloc(int32_t size, const char* id);
+void* NMemoryProfiler_malloc(int64_t size, const char* id);
+void* NMemoryProfiler_realloc(void* address, int64_t size, const char* id);
 void NMemoryProfiler_free(void* address, const char* id);
 void NMemoryProfiler_logOnExitReport();
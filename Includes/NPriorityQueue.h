@@ -0,0 +1,61 @@
+// Binary min-heaps over NVector storage. The object that compares least is always on top. Push
+// and pop are O(log n), peek is O(1).
+//
+// When no comparator is provided (comparator is 0), objects are expected to start with an int64_t
+// key (for example, a timer's deadline), which is compared directly. This avoids calling through
+// a function pointer for every comparison, and is the fastest option for timer-like workloads.
+//
+// NIndexedPriorityQueue additionally identifies objects by ids, so that queued objects can be
+// updated (decrease-key or increase-key) or removed in O(log n).
+
+#pragma once
+
+#include <NTypes.h>
+#include <NVector.h>
+
+struct NPriorityQueue {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    struct NVector heap;
+    int32_t (*comparator)(const void* object1, const void* object2);
+};
+
+struct NPriorityQueue_Interface {
+    struct NPriorityQueue* (*initialize)(struct NPriorityQueue* outputQueue, NVectorSize initialCapacity, uint32_t objectSize, int32_t (*comparator)(const void* object1, const void* object2));
+    struct NPriorityQueue* (*create)(NVectorSize initialCapacity, uint32_t objectSize, int32_t (*comparator)(const void* object1, const void* object2));
+    struct NPriorityQueue* (*initializeFromVector)(struct NPriorityQueue* outputQueue, struct NVector* vector, int32_t (*comparator)(const void* object1, const void* object2)); // O(n). Takes over the vector's storage, leaving it empty.
+    void (*destroy)(struct NPriorityQueue* queue);
+    void (*destroyAndFree)(struct NPriorityQueue* queue);
+    struct NPriorityQueue* (*clear)(struct NPriorityQueue* queue);
+    boolean (*push)(struct NPriorityQueue* queue, const void* object); // True if successful.
+    boolean (*pop)(struct NPriorityQueue* queue, void* outputObject);  // Pops the least object. True if successful.
+    void* (*peek)(struct NPriorityQueue* queue);                       // The least object, 0 if empty.
+    NVectorSize (*size)(struct NPriorityQueue* queue);
+};
+
+extern const struct NPriorityQueue_Interface NPriorityQueue;
+
+struct NIndexedPriorityQueue {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    struct NVector heap;      // Ids (NVectorSize), in heap order.
+    struct NVector positions; // Per id, its index in heap (NVectorIndex), -1 if not queued.
+    struct NVector objects;   // Per id, its object.
+    int32_t (*comparator)(const void* object1, const void* object2);
+};
+
+struct NIndexedPriorityQueue_Interface {
+    struct NIndexedPriorityQueue* (*initialize)(struct NIndexedPriorityQueue* outputQueue, NVectorSize initialCapacity, uint32_t objectSize, int32_t (*comparator)(const void* object1, const void* object2));
+    struct NIndexedPriorityQueue* (*create)(NVectorSize initialCapacity, uint32_t objectSize, int32_t (*comparator)(const void* object1, const void* object2));
+    void (*destroy)(struct NIndexedPriorityQueue* queue);
+    void (*destroyAndFree)(struct NIndexedPriorityQueue* queue);
+    struct NIndexedPriorityQueue* (*clear)(struct NIndexedPriorityQueue* queue);
+    boolean (*push)(struct NIndexedPriorityQueue* queue, NVectorSize id, const void* object); // Ids are small non-negative integers chosen by the user. If already queued, same as update().
+    boolean (*update)(struct NIndexedPriorityQueue* queue, NVectorSize id, const void* object); // Replaces the object of a queued id, restoring the order. False if not queued.
+    boolean (*remove)(struct NIndexedPriorityQueue* queue, NVectorSize id); // False if not queued.
+    boolean (*pop)(struct NIndexedPriorityQueue* queue, NVectorSize* outputId, void* outputObject); // Pops the least object. Outputs can be 0. True if successful.
+    boolean (*peek)(struct NIndexedPriorityQueue* queue, NVectorSize* outputId); // The id of the least object. False if empty.
+    boolean (*contains)(struct NIndexedPriorityQueue* queue, NVectorSize id);
+    void* (*get)(struct NIndexedPriorityQueue* queue, NVectorSize id); // The object of a queued id, 0 if not queued.
+    NVectorSize (*size)(struct NIndexedPriorityQueue* queue);
+};
+
+extern const struct NIndexedPriorityQueue_Interface NIndexedPriorityQueue;
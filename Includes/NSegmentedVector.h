@@ -0,0 +1,70 @@
+// A vector that grows by appending fixed-size chunks instead of reallocating. Existing objects are
+// never moved, so pointers to them remain valid for as long as they are in the vector. Indexing is
+// still O(1), through a table of chunk pointers. Chunks hold a power of two number of objects, and
+// are kept when the vector shrinks, to be reused.
+
+#pragma once
+
+#include <NTypes.h>
+#include <NVector.h>
+
+#define NSEGMENTED_VECTOR_DEFAULT_CHUNK_SIZE 4096  // Bytes. Used when objectsPerChunk is 0.
+
+struct NSegmentedVector {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    uint32_t objectSize;
+    uint32_t chunkShift;   // Objects per chunk = 1 << chunkShift.
+    NVectorSize objectsCount;
+    struct NVector chunks; // Chunk pointers.
+};
+
+struct NSegmentedVector_Interface {
+    struct NSegmentedVector* (*initialize)(struct NSegmentedVector* outputVector, uint32_t objectsPerChunk, uint32_t objectSize); // objectsPerChunk is rounded up to a power of 2.
+    struct NSegmentedVector* (*create)(uint32_t objectsPerChunk, uint32_t objectSize);
+    void (*destroy)(struct NSegmentedVector* vector);
+    void (*destroyAndFree)(struct NSegmentedVector* vector);
+    struct NSegmentedVector* (*clear)(struct NSegmentedVector* vector);
+    NVectorSize (*capacity)(struct NSegmentedVector* vector);
+    boolean (*ensureCapacity)(struct NSegmentedVector* vector, NVectorSize additionalCapacity); // Allocates the missing chunks.
+    void* (*emplaceBack)(struct NSegmentedVector* vector);  // New structure pointer if successful, 0 otherwise.
+    boolean (*pushBack)(struct NSegmentedVector* vector, const void *object);  // True if successful.
+    boolean (*pushBackBulk)(struct NSegmentedVector* vector, const void *objects, NVectorSize objectsCount);  // True if successful.
+    boolean (*popBack)(struct NSegmentedVector* vector, void *outputObject);   // True if successful.
+    void* (*get)(struct NSegmentedVector* vector, NVectorSize index);
+    void* (*getLast)(struct NSegmentedVector* vector);
+    NVectorIndex (*getFirstInstanceIndex)(struct NSegmentedVector* vector, const void* object); // -1 if not found.
+    boolean (*insertRange)(struct NSegmentedVector* vector, NVectorSize index, const void *objects, NVectorSize objectsCount);  // True if successful. objects must not point into the vector.
+    void (*remove)(struct NSegmentedVector* vector, NVectorIndex index); // Preserves order, O(n).
+    void (*removeRange)(struct NSegmentedVector* vector, NVectorSize startIndex, NVectorSize objectsCount);
+    void (*swapRemove)(struct NSegmentedVector* vector, NVectorIndex index); // O(1), replaces the removed object with the last one.
+    NVectorSize (*size)(struct NSegmentedVector* vector);
+    boolean (*resize)(struct NSegmentedVector* vector, NVectorSize newSize);
+};
+
+extern const struct NSegmentedVector_Interface NSegmentedVector;
+
+#if NSTDLIB_INLINE
+
+static inline void* NSegmentedVector_get(struct NSegmentedVector* vector, NVectorSize index) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if (index >= vector->objectsCount) return 0;
+    #endif
+
+    uint8_t* chunk = ((uint8_t**) vector->chunks.objects)[index >> vector->chunkShift];
+    return &chunk[(index & ((((NVectorSize) 1) << vector->chunkShift) - 1)) * vector->objectSize];
+}
+
+static inline void* NSegmentedVector_emplaceBack(struct NSegmentedVector* vector) {
+
+    // Allocate a new chunk if needed,
+    if ((vector->objectsCount == (vector->chunks.objectsCount << vector->chunkShift)) && !NSegmentedVector.ensureCapacity(vector, 1)) return 0;
+
+    vector->objectsCount++;
+    return NSegmentedVector_get(vector, vector->objectsCount-1);
+}
+
+static inline NVectorSize NSegmentedVector_size(struct NSegmentedVector* vector) {
+    return vector->objectsCount;
+}
+
+#endif
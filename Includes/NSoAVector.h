@@ -0,0 +1,60 @@
+// Structure of arrays. Stores the fields of every object in parallel columns (one NVector each)
+// sharing a single objects count. Each column is contiguous, so a loop over a single field only
+// touches that field's memory, and can be vectorized. All the columns grow together.
+//
+// Example:
+//    uint32_t columnSizes[] = { sizeof(int64_t), sizeof(float) };
+//    struct NSoAVector particles;
+//    NSoAVector.initialize(&particles, 0, 2, columnSizes);
+//    void* fields[2];
+//    NSoAVector.emplaceBack(&particles, fields);
+//    *(int64_t*) fields[0] = 7; *(float*) fields[1] = 0.5f;
+//    float* masses = NSoAVector.getColumn(&particles, 1);
+//    for (NVectorSize i=0; i<NSoAVector.size(&particles); i++) masses[i] *= 2;
+//    NSoAVector.destroy(&particles);
+
+#pragma once
+
+#include <NTypes.h>
+#include <NVector.h>
+
+struct NSoAVector {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    NVectorSize capacity;
+    NVectorSize objectsCount;
+    int32_t growthPolicy;  // One of NGrowthPolicy values.
+    uint32_t maxObjectSize; // Of all columns. Used when applying the growth policy.
+    struct NVector columns; // A struct NVector per column, kept at the same capacity and count.
+};
+
+struct NSoAVector_Interface {
+    struct NSoAVector* (*initialize)(struct NSoAVector* outputVector, NVectorSize initialCapacity, uint32_t columnsCount, const uint32_t* columnObjectSizes);
+    struct NSoAVector* (*create)(NVectorSize initialCapacity, uint32_t columnsCount, const uint32_t* columnObjectSizes);
+    void (*destroy)(struct NSoAVector* vector);
+    void (*destroyAndFree)(struct NSoAVector* vector);
+    struct NSoAVector* (*clear)(struct NSoAVector* vector);
+    struct NSoAVector* (*setGrowthPolicy)(struct NSoAVector* vector, int32_t growthPolicy); // Returns vector. Call right after initializing.
+    boolean (*ensureCapacity)(struct NSoAVector* vector, NVectorSize additionalCapacity); // Grows all columns according to the growth policy.
+    boolean (*emplaceBack)(struct NSoAVector* vector, void** outputColumnPointers); // Sets a pointer per column to the new object's fields (if outputColumnPointers isn't 0). True if successful.
+    boolean (*popBack)(struct NSoAVector* vector, void** outputFields); // Copies the last object's fields into outputFields (entries can be 0 to skip). True if successful.
+    void (*swapRemove)(struct NSoAVector* vector, NVectorIndex index); // O(1), replaces the removed object with the last one.
+    void* (*get)(struct NSoAVector* vector, uint32_t columnIndex, NVectorSize index);
+    void* (*getColumn)(struct NSoAVector* vector, uint32_t columnIndex); // Contiguous, size() elements. Invalidated on growth.
+    uint32_t (*columnsCount)(struct NSoAVector* vector);
+    NVectorSize (*size)(struct NSoAVector* vector);
+    boolean (*resize)(struct NSoAVector* vector, NVectorSize newSize);
+};
+
+extern const struct NSoAVector_Interface NSoAVector;
+
+#if NSTDLIB_INLINE
+
+static inline void* NSoAVector_getColumn(struct NSoAVector* vector, uint32_t columnIndex) {
+    return ((struct NVector*) vector->columns.objects)[columnIndex].objects;
+}
+
+static inline NVectorSize NSoAVector_size(struct NSoAVector* vector) {
+    return vector->objectsCount;
+}
+
+#endif
@@ -6,17 +6,30 @@
 #pragma once
 
 #include <NByteVector.h>
+#include <NVector.h>
 #include <NVarArgs.h>
 
 struct NString {
     struct NByteVector string;
 };
 
+// A format string parsed once into literal spans and typed argument slots, for formats used
+// repeatedly. The literal text is copied, so the source string doesn't need to outlive it,
+struct NStringFormat {
+    // DON'T OVERWRITE. For use by the provided functions only.
+    struct NVector segments;
+    struct NByteVector literals;
+    int32_t argumentsCount;
+};
+
 struct NString_Interface {
     struct NString* (*initialize)(struct NString* string, const char* format, ...);
     void (*destroy)(struct NString* string);
     void (*destroyAndFree)(struct NString* string);
 
+    // Formats support %s %c %d %i %u %x %X %p %f %e %E %g %G and %%, the length modifiers l (always
+    // 64bit) and z (size_t), the flags - 0 + space and #, a field width and a .precision (both can
+    // be *). %f without a precision uses the shortest representation,
     struct NString* (*vAppend)(struct NString* outString, const char* format, va_list vaList);
     struct NString* (* append)(struct NString* outString, const char* format, ...);
     struct NString* (*    set)(struct NString* outString, const char* format, ...);
@@ -26,8 +39,63 @@ struct NString_Interface {
     struct NString* (*trim     )(struct NString* string, const char* symbolsToBeRemoved);
     struct NString* (*create)(const char* format, ...);
     struct NString* (*replace)(const char* textToBeSearched, const char* textToBeRemoved, const char* textToBeInserted);
-    struct NString* (*subString)(struct NString* string, int32_t startIndex, int32_t endIndex);
-    int32_t (*length)(struct NString* string);
+    struct NString* (*subString)(struct NString* string, NVectorIndex startIndex, NVectorIndex endIndex);
+    NVectorIndex (*length)(struct NString* string);
+
+    struct NString* (*initializeWithBuffer)(struct NString* string, char* buffer, NVectorSize bufferSize, const char* format, ...); // Uses buffer (e.g., on the stack) instead of the heap until outgrown. buffer must outlive the string.
+    struct NString* (*appendReplaced)(struct NString* outString, const char* textToBeSearched, const char* textToBeRemoved, const char* textToBeInserted);
+
+    // Zero-copy appending. reserveWritable() returns a pointer to at least size writable characters
+    // at the end of the string (0 if failed). commit() appends the written characters and
+    // terminates the string. The string isn't terminated in between,
+    char* (*reserveWritable)(struct NString* string, NVectorSize size);
+    boolean (*commit)(struct NString* string, NVectorSize writtenSize); // True if successful.
+
+    // Same as vAppend() and append(), using a compiled format (see NStringFormat),
+    struct NString* (*vAppendCompiled)(struct NString* outString, const struct NStringFormat* format, va_list vaList);
+    struct NString* (* appendCompiled)(struct NString* outString, const struct NStringFormat* format, ...);
+
+    // The shortest representation that reads back as the same value (same as %f without a
+    // precision). appendFloat() uses the float's precision, so 0.1f gives "0.1",
+    struct NString* (*appendFloat )(struct NString* outString, float value);
+    struct NString* (*appendDouble)(struct NString* outString, double value);
+};
+
+struct NStringFormat_Interface {
+    struct NStringFormat* (*initialize)(struct NStringFormat* outputFormat, const char* format); // 0 if the format is invalid.
+    struct NStringFormat* (*create)(const char* format); // 0 if the format is invalid.
+    void (*destroy)(struct NStringFormat* format);
+    void (*destroyAndFree)(struct NStringFormat* format);
+
+    // Compiles a format on first use, and returns the same instance afterwards. Keyed by the format
+    // pointer, not its contents, so meant for string literals. Not thread-safe,
+    const struct NStringFormat* (*getCached)(const char* format); // 0 if the format is invalid.
+    void (*clearCache)(); // Destroys the cached formats.
 };
 
 extern const struct NString_Interface NString;
+extern const struct NStringFormat_Interface NStringFormat;
+
+#if NSTDLIB_INLINE
+
+static inline const char* NString_get(struct NString* string) {
+    return (const char*) string->string.objects;
+}
+
+static inline NVectorIndex NString_length(struct NString* string) {
+    return string->string.size - 1;
+}
+
+static inline char* NString_reserveWritable(struct NString* string, NVectorSize size) {
+    // The termination zero is overwritten, and restored on commit,
+    if (!NByteVector_reserveWritable(&string->string, size)) return 0;
+    return (char*) &string->string.objects[string->string.size - 1];
+}
+
+static inline boolean NString_commit(struct NString* string, NVectorSize writtenSize) {
+    if (!NByteVector_commit(&string->string, writtenSize)) return False;
+    string->string.objects[string->string.size - 1] = 0;
+    return True;
+}
+
+#endif
@@ -33,11 +33,13 @@
     #define NPROFILE_MEMORY 1
 #endif
 #if NPROFILE_MEMORY > 0
-    #define NMALLOC(size   , id) NMemoryProfiler_malloc(size   , id)
-    #define   NFREE(address, id) NMemoryProfiler_free  (address, id)
+    #define   NMALLOC(size         , id) NMemoryProfiler_malloc (size         , id)
+    #define  NREALLOC(address, size, id) NMemoryProfiler_realloc(address, size, id)
+    #define     NFREE(address      , id) NMemoryProfiler_free   (address      , id)
 #else
-    #define NMALLOC(size   , id) NSystemUtils.malloc(size   )
-    #define   NFREE(address, id) NSystemUtils.free  (address)
+    #define   NMALLOC(size         , id) NSystemUtils.malloc (size         )
+    #define  NREALLOC(address, size, id) NSystemUtils.realloc(address, size)
+    #define     NFREE(address      , id) NSystemUtils.free   (address      )
 #endif
 
 #define NTCOLOR(color) NTerminalColor.color
@@ -52,12 +54,12 @@ struct NDirectoryEntry {
 struct NSystemUtils_Interface {
 
     // Memory management,
-    void* (*malloc)(int32_t size);
+    void* (*malloc)(int64_t size);
     void (*free)(void* address);
-    void* (*memset)(void* address, int value, int32_t length); // Returns address.
-    void* (*memcpy )(void* dest, const void* src, int32_t length); // Returns destination.
-    void* (*memmove)(void* dest, const void* src, int32_t length); // Returns destination.
-    int32_t (*memcmp)(const void* ptr1, const void* ptr2, int32_t length); // Returns 0 if equal, or a value indicating which is larger.
+    void* (*memset)(void* address, int value, int64_t length); // Returns address.
+    void* (*memcpy )(void* dest, const void* src, int64_t length); // Returns destination.
+    void* (*memmove)(void* dest, const void* src, int64_t length); // Returns destination.
+    int32_t (*memcmp)(const void* ptr1, const void* ptr2, int64_t length); // Returns 0 if equal, or a value indicating which is larger.
 
     // Log,
     void (*logI)(const char* tag, const char* format, ...);
@@ -79,6 +81,9 @@ struct NSystemUtils_Interface {
     void (*getTime)(int64_t* outTimeSeconds, int64_t* outTimeNanos);
     boolean (*isNaN)(double value);
     boolean (*isInf)(double value);
+
+    void* (*realloc)(void* address, int64_t size); // Returns the (possibly moved) block, 0 if failed (the original block is then left untouched).
+    boolean (*writeBuffersToFile)(const char* filePath, const void* const* buffers, const int64_t* sizes, int32_t buffersCount, boolean append); // Gathers all buffers in as few system calls as possible. Returns success.
 };
 
 extern const struct NSystemUtils_Interface NSystemUtils;
@@ -0,0 +1,74 @@
+// Statically typed vectors. NVECTOR_DEFINE(Name, Type) emits a set of inline functions that
+// operate on a regular struct NVector whose objectSize is sizeof(Type). Elements are accessed
+// through typed pointers, so the compiler emits plain loads/stores (and can vectorize loops)
+// instead of going through NSystemUtils.memcpy. Since the layout is shared, a vector can be
+// passed freely between the typed functions and the generic NVector interface.
+//
+// Example:
+//    NVECTOR_DEFINE(NVectorFloat, float)
+//    struct NVector values;
+//    NVectorFloat_initialize(&values, 16);
+//    NVectorFloat_pushBack(&values, 3.5f);
+//    float last = *NVectorFloat_getLast(&values);
+//    NVector.destroy(&values);
+
+#pragma once
+
+#include <NVector.h>
+
+#define NVECTOR_DEFINE(Name, Type) \
+    static inline struct NVector* Name##_initialize(struct NVector* outputVector, NVectorSize initialCapacity) { \
+        return NVector.initialize(outputVector, initialCapacity, sizeof(Type)); \
+    } \
+    \
+    static inline struct NVector* Name##_create(NVectorSize initialCapacity) { \
+        return NVector.create(initialCapacity, sizeof(Type)); \
+    } \
+    \
+    static inline Type* Name##_data(struct NVector* vector) { \
+        return (Type*) vector->objects; \
+    } \
+    \
+    static inline Type* Name##_emplaceBack(struct NVector* vector) { \
+        if ((vector->objectsCount == vector->capacity) && \
+            !NVector.ensureCapacity(vector, 1)) return 0; \
+        return &((Type*) vector->objects)[vector->objectsCount++]; \
+    } \
+    \
+    static inline boolean Name##_pushBack(struct NVector* vector, Type object) { \
+        if ((vector->objectsCount == vector->capacity) && \
+            !NVector.ensureCapacity(vector, 1)) return False; \
+        ((Type*) vector->objects)[vector->objectsCount++] = object; \
+        return True; \
+    } \
+    \
+    static inline boolean Name##_popBack(struct NVector* vector, Type* outputObject) { \
+        if (!vector->objectsCount) return False; \
+        *outputObject = ((Type*) vector->objects)[--vector->objectsCount]; \
+        return True; \
+    } \
+    \
+    static inline Type* Name##_get(struct NVector* vector, NVectorSize index) { \
+        if (NVECTOR_BOUNDARY_CHECK && (index >= vector->objectsCount)) return 0; \
+        return &((Type*) vector->objects)[index]; \
+    } \
+    \
+    static inline Type* Name##_getLast(struct NVector* vector) { \
+        if (!vector->objectsCount) return 0; \
+        return &((Type*) vector->objects)[vector->objectsCount-1]; \
+    } \
+    \
+    static inline boolean Name##_set(struct NVector* vector, NVectorSize index, Type object) { \
+        if (NVECTOR_BOUNDARY_CHECK && (index >= vector->objectsCount)) return False; \
+        ((Type*) vector->objects)[index] = object; \
+        return True; \
+    } \
+    \
+    static inline NVectorSize Name##_size(struct NVector* vector) { \
+        return vector->objectsCount; \
+    }
+
+// Common specializations,
+NVECTOR_DEFINE(NVector32, int32_t)
+NVECTOR_DEFINE(NVector64, int64_t)
+NVECTOR_DEFINE(NVectorPointer, void*)
@@ -1,4 +1,3 @@
-
 //////////////////////////////////////////////////////
 // Created by Omar El Sayyed on 26th of July 2021.
 //////////////////////////////////////////////////////
@@ -10,4 +9,35 @@
 #ifndef BOOL
 #define BOOL
 typedef enum { False=0, True=1 } boolean;
-#endif
\ No newline at end of file
+#endif
+
+// NVECTOR_64BIT values:
+//   0: 32bit sizes and indices (default). NVector, NByteVector and NString hold up to 4G objects.
+//   1: 64bit sizes and indices, for holding large in-memory datasets (more than 4GB).
+#ifndef NVECTOR_64BIT
+    #define NVECTOR_64BIT 0
+#endif
+#if NVECTOR_64BIT
+    typedef uint64_t NVectorSize;
+    typedef  int64_t NVectorIndex; // Signed, so that -1 can indicate "not found".
+    #define NVECTOR_MAX_ALLOCATION_SIZE 0x7fffffffffffffffULL
+#else
+    typedef uint32_t NVectorSize;
+    typedef  int32_t NVectorIndex;
+    #define NVECTOR_MAX_ALLOCATION_SIZE 0xffffffffULL
+#endif
+
+// NSTDLIB_INLINE values:
+//   0: None (default). Everything goes through the interfaces (NVector.pushBack, ...).
+//   1: Also expose the hot functions as static inline functions next to their interfaces (for
+//      example, NVector_pushBack, NByteVector_pushBack and NCString_length). They share the same
+//      structs and behavior as the interface functions, so both can be mixed freely.
+#ifndef NSTDLIB_INLINE
+    #define NSTDLIB_INLINE 0
+#endif
+
+// Used by the inline functions instead of NSystemUtils.memcpy, so small copies can be turned into
+// plain loads/stores. Override if the compiler builtin isn't available for your target.
+#ifndef NSTDLIB_INLINE_MEMCPY
+    #define NSTDLIB_INLINE_MEMCPY(dest, src, length) __builtin_memcpy(dest, src, length)
+#endif
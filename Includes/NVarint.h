@@ -0,0 +1,54 @@
+// Variable length integers (LEB128). Every byte holds 7 bits of the value, least significant
+// first, with the high bit set on all bytes but the last. Small values take fewer bytes: below
+// 128 takes 1 byte, below 16384 takes 2 bytes, and so on, up to 10 bytes for 64bit values.
+//
+// Signed values are zigzag encoded first (0, -1, 1, -2, 2... map to 0, 1, 2, 3, 4...) so that
+// small negative values remain small.
+//
+// Sorted arrays are best stored as deltas, which are usually much smaller than the values.
+//
+// Decode functions return the number of bytes consumed, or 0 if the data is truncated or
+// malformed.
+
+#pragma once
+
+#include <NTypes.h>
+#include <NByteVector.h>
+
+#define NVARINT_MAX_SIZE 10 // Bytes, for a 64bit value.
+
+struct NVarint_Interface {
+    uint64_t (*zigzagEncode)(int64_t value);
+    int64_t (*zigzagDecode)(uint64_t value);
+    int32_t (*size)(uint64_t value); // Encoded size in bytes.
+
+    boolean (*pushBack)(struct NByteVector* vector, uint64_t value); // True if successful.
+    boolean (*pushBackSigned)(struct NByteVector* vector, int64_t value); // Zigzag encoded. True if successful.
+    NVectorSize (*decode)(const void* data, NVectorSize dataSize, uint64_t* outputValue);
+    NVectorSize (*decodeSigned)(const void* data, NVectorSize dataSize, int64_t* outputValue);
+
+    boolean (*pushBackBulk)(struct NByteVector* vector, const uint64_t* values, NVectorSize valuesCount); // True if successful.
+    NVectorSize (*decodeBulk)(const void* data, NVectorSize dataSize, uint64_t* outputValues, NVectorSize valuesCount);
+
+    boolean (*pushBackDeltas)(struct NByteVector* vector, const uint64_t* sortedValues, NVectorSize valuesCount); // Values must be non-decreasing. True if successful.
+    NVectorSize (*decodeDeltas)(const void* data, NVectorSize dataSize, uint64_t* outputValues, NVectorSize valuesCount);
+};
+
+extern const struct NVarint_Interface NVarint;
+
+#if NSTDLIB_INLINE
+
+static inline uint64_t NVarint_zigzagEncode(int64_t value) {
+    return (((uint64_t) value) << 1) ^ (uint64_t) (value >> 63);
+}
+
+static inline int64_t NVarint_zigzagDecode(uint64_t value) {
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+static inline int32_t NVarint_size(uint64_t value) {
+    // 7 bits per byte, at least 1 byte,
+    return (70 - __builtin_clzll(value | 1)) / 7;
+}
+
+#endif
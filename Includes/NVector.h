@@ -6,37 +6,113 @@
 // Note: this is a generic (slow) implementation. A specialized implementation for 32bit integers
 // is thus highly recommended. This can be achieved while maintaining high performance by creating
 // a new set of functions and a different interface to handle the 32bit specialized case. For
-// example, NByteVector and NVector32.
+// example, NByteVector and NVector32 (see NTypedVector.h, which can generate such specializations
+// for any type while keeping this struct's layout).
 
 #pragma once
 
 #include <NTypes.h>
+#include <NGrowthPolicy.h>
+
+#ifndef NVECTOR_BOUNDARY_CHECK
+    #define NVECTOR_BOUNDARY_CHECK 1
+#endif
 
 struct NVector {
     // DON'T OVERWRITE. For use by the provided functions only.
-    uint32_t capacity;
+    NVectorSize capacity;
     uint32_t objectSize;
-    uint32_t objectsCount;
+    NVectorSize objectsCount;
     void* objects;
+    int32_t growthPolicy;  // One of NGrowthPolicy values. Appended, to keep the original layout.
 };
 
 struct NVector_Interface {
-    struct NVector* (*initialize)(struct NVector* outputVector, uint32_t initialCapacity, uint32_t objectSize);
-    struct NVector* (*create)(uint32_t initialCapacity, uint32_t objectSize);
+    struct NVector* (*initialize)(struct NVector* outputVector, NVectorSize initialCapacity, uint32_t objectSize);
+    struct NVector* (*create)(NVectorSize initialCapacity, uint32_t objectSize);
     struct NVector* (*initializeFrom)(struct NVector* outputVector, struct NVector* vectorToCopy);
     void (*destroy)(struct NVector* vector);
     void (*destroyAndFree)(struct NVector* vector);
     struct NVector* (*clear)(struct NVector* vector);
-    boolean (*grow)(struct NVector* vector, uint32_t newCapacity);
+    boolean (*grow)(struct NVector* vector, NVectorSize newCapacity);
     void* (*emplaceBack)(struct NVector* vector);  // New structure pointer if successful, 0 otherwise.
     boolean (*pushBack)(struct NVector* vector, const void *object);  // True if successful.
     boolean (*popBack)(struct NVector* vector, void *outputObject);   // True if successful.
-    void* (*get)(struct NVector* vector, uint32_t index);
+    void* (*get)(struct NVector* vector, NVectorSize index);
     void* (*getLast)(struct NVector* vector);
-    int32_t (*getFirstInstanceIndex)(struct NVector* vector, const void* object); // -1 if not found.
-    void (*remove)(struct NVector* vector, int32_t index);
-    uint32_t (*size)(struct NVector* vector);
-    boolean (*resize)(struct NVector* vector, uint32_t newSize);
+    NVectorIndex (*getFirstInstanceIndex)(struct NVector* vector, const void* object); // -1 if not found.
+    void (*remove)(struct NVector* vector, NVectorIndex index);
+    NVectorSize (*size)(struct NVector* vector);
+    boolean (*resize)(struct NVector* vector, NVectorSize newSize);
+
+    struct NVector* (*setGrowthPolicy)(struct NVector* vector, int32_t growthPolicy); // Returns vector. Call right after initializing.
+    boolean (*ensureCapacity)(struct NVector* vector, NVectorSize additionalCapacity); // Grows according to the growth policy.
+    boolean (*pushBackBulk)(struct NVector* vector, const void *objects, NVectorSize objectsCount);  // True if successful. objects may point into the vector itself.
+    boolean (*insertRange)(struct NVector* vector, NVectorSize index, const void *objects, NVectorSize objectsCount);  // True if successful. objects may point into the vector itself.
+    void (*removeRange)(struct NVector* vector, NVectorSize startIndex, NVectorSize objectsCount);
+    NVectorSize (*removeIf)(struct NVector* vector, boolean (*predicate)(void* object, void* context), void* context); // Returns removed objects count. Preserves order.
+    void (*swapRemove)(struct NVector* vector, NVectorIndex index); // O(1), replaces the removed object with the last one.
+
+    // Sorting and searching. Comparators return a negative value, zero or a positive value if
+    // object1 is less than, equal to or greater than object2, respectively,
+    void (*sort)(struct NVector* vector, int32_t (*comparator)(const void* object1, const void* object2)); // Introsort, not stable.
+    boolean (*stableSort)(struct NVector* vector, int32_t (*comparator)(const void* object1, const void* object2)); // Merge sort, needs a temporary buffer. True if successful.
+    boolean (*radixSort)(struct NVector* vector, uint32_t keyOffset, uint32_t keySize, boolean isSigned); // Stable. Sorts by a 4 or 8 bytes integer key at keyOffset in every object. True if successful.
+    NVectorIndex (*binarySearch)(struct NVector* vector, const void* object, int32_t (*comparator)(const void* object1, const void* object2)); // Vector must be sorted. -1 if not found.
+    NVectorSize (*lowerBound)(struct NVector* vector, const void* object, int32_t (*comparator)(const void* object1, const void* object2)); // Vector must be sorted. Index of the first object not less than object.
+
+    NVectorSize (*countInstances)(struct NVector* vector, const void* object);
+    NVectorSize (*findAllInstances)(struct NVector* vector, const void* object, struct NVector* outIndices); // Pushes the indices (as NVectorSize) into outIndices. Returns the found instances count.
 };
 
 extern const struct NVector_Interface NVector;
+
+#if NSTDLIB_INLINE
+
+static inline void* NVector_emplaceBack(struct NVector* vector) {
+
+    // Expand the vector capacity if needed,
+    if ((vector->objectsCount == vector->capacity) && !NVector.ensureCapacity(vector, 1)) return 0;
+
+    // Make way for a new entry,
+    void *newObjectPointer = (void *)(((intptr_t) vector->objects) + (vector->objectsCount * vector->objectSize));
+    vector->objectsCount++;
+
+    return newObjectPointer;
+}
+
+static inline boolean NVector_pushBack(struct NVector* vector, const void *object) {
+    void *newObjectPointer = NVector_emplaceBack(vector);
+    if (!newObjectPointer) return False;
+    NSTDLIB_INLINE_MEMCPY(newObjectPointer, object, vector->objectSize);
+    return True;
+}
+
+static inline boolean NVector_popBack(struct NVector* vector, void *outputObject) {
+    if (vector->objectsCount==0) return False;
+
+    vector->objectsCount--;
+    void *lastObjectPointer = (void *)(((intptr_t) vector->objects) + (vector->objectsCount * vector->objectSize));
+    NSTDLIB_INLINE_MEMCPY(outputObject, lastObjectPointer, vector->objectSize);
+
+    return True;
+}
+
+static inline void* NVector_get(struct NVector* vector, NVectorSize index) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if (index >= vector->objectsCount) return 0;
+    #endif
+
+    return (void *)(((intptr_t) vector->objects) + (index * vector->objectSize));
+}
+
+static inline void* NVector_getLast(struct NVector* vector) {
+    if (!vector->objectsCount) return 0;
+    return (void *)(((intptr_t) vector->objects) + ((vector->objectsCount-1) * vector->objectSize));
+}
+
+static inline NVectorSize NVector_size(struct NVector* vector) {
+    return vector->objectsCount;
+}
+
+#endif
@@ -0,0 +1,247 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NByteChain.h>
+#include <NSystemUtils.h>
+#include <NError.h>
+
+// Up to this many segments are written without allocating the buffers list,
+#define WRITE_STACK_BUFFERS_COUNT 64
+
+static struct NByteChainSegment* createSegment(NVectorSize capacity) {
+    if (capacity > NVECTOR_MAX_ALLOCATION_SIZE - sizeof(struct NByteChainSegment)) return 0;
+
+    struct NByteChainSegment* segment = NMALLOC(sizeof(struct NByteChainSegment) + capacity, "NByteChain.createSegment() segment");
+    if (!segment) return 0;
+    segment->next = 0;
+    segment->size = 0;
+    segment->capacity = capacity;
+    return segment;
+}
+
+static inline void linkSegment(struct NByteChain* chain, struct NByteChainSegment* segment) {
+    if (chain->lastSegment) {
+        chain->lastSegment->next = segment;
+    } else {
+        chain->firstSegment = segment;
+    }
+    chain->lastSegment = segment;
+    chain->segmentsCount++;
+}
+
+static struct NByteChain* initialize(struct NByteChain* outputChain, NVectorSize segmentCapacity) {
+    NSystemUtils.memset(outputChain, 0, sizeof(struct NByteChain));
+    outputChain->segmentCapacity = segmentCapacity ? segmentCapacity : NBYTECHAIN_DEFAULT_SEGMENT_CAPACITY;
+    return outputChain;
+}
+
+static struct NByteChain* create(NVectorSize segmentCapacity) {
+    struct NByteChain* newChain = NMALLOC(sizeof(struct NByteChain), "NByteChain.create() newChain");
+    return initialize(newChain, segmentCapacity);
+}
+
+static struct NByteChain* clear(struct NByteChain* chain) {
+    struct NByteChainSegment* segment = chain->firstSegment;
+    while (segment) {
+        struct NByteChainSegment* nextSegment = segment->next;
+        NFREE(segment, "NByteChain.createSegment() segment");
+        segment = nextSegment;
+    }
+
+    chain->firstSegment = 0;
+    chain->lastSegment = 0;
+    chain->size = 0;
+    chain->segmentsCount = 0;
+    return chain;
+}
+
+static void destroy(struct NByteChain* chain) {
+    clear(chain);
+    NSystemUtils.memset(chain, 0, sizeof(struct NByteChain));
+}
+
+static void destroyAndFree(struct NByteChain* chain) {
+    destroy(chain);
+    NFREE(chain, "NByteChain.destroyAndFree() chain");
+}
+
+static boolean pushBackBulk(struct NByteChain* chain, const void* data, NVectorSize size) {
+
+    const uint8_t* source = data;
+    while (size) {
+
+        // Link a new segment if the last one is full,
+        struct NByteChainSegment* segment = chain->lastSegment;
+        if (!segment || (segment->size == segment->capacity)) {
+            segment = createSegment(chain->segmentCapacity);
+            if (!segment) return False;
+            linkSegment(chain, segment);
+        }
+
+        // Fill it,
+        NVectorSize copiedSize = segment->capacity - segment->size;
+        if (copiedSize > size) copiedSize = size;
+        NSystemUtils.memcpy(&segment->data[segment->size], source, copiedSize);
+        segment->size += copiedSize;
+        chain->size += copiedSize;
+        source += copiedSize;
+        size -= copiedSize;
+    }
+
+    return True;
+}
+
+static boolean pushBack(struct NByteChain* chain, uint8_t value) {
+    return NByteChain_pushBack(chain, value);
+}
+
+static void* reserveWritable(struct NByteChain* chain, NVectorSize size) {
+
+    // Use the last segment if it has enough room, otherwise link a new one (large enough),
+    struct NByteChainSegment* segment = chain->lastSegment;
+    if (!segment || (segment->capacity - segment->size < size)) {
+        segment = createSegment((size > chain->segmentCapacity) ? size : chain->segmentCapacity);
+        if (!segment) return 0;
+        linkSegment(chain, segment);
+    }
+
+    return &segment->data[segment->size];
+}
+
+static boolean commit(struct NByteChain* chain, NVectorSize writtenSize) {
+    struct NByteChainSegment* segment = chain->lastSegment;
+    if (!segment) return !writtenSize;
+    if (writtenSize > segment->capacity - segment->size) return False;
+
+    segment->size += writtenSize;
+    chain->size += writtenSize;
+    return True;
+}
+
+static struct NByteChain* splice(struct NByteChain* chain, struct NByteChain* chainToAppend) {
+    // A chain can't be appended to itself,
+    if ((chainToAppend == chain) || !chainToAppend->firstSegment) return chain;
+
+    // Link the segments as they are,
+    if (chain->lastSegment) {
+        chain->lastSegment->next = chainToAppend->firstSegment;
+    } else {
+        chain->firstSegment = chainToAppend->firstSegment;
+    }
+    chain->lastSegment = chainToAppend->lastSegment;
+    chain->size += chainToAppend->size;
+    chain->segmentsCount += chainToAppend->segmentsCount;
+
+    chainToAppend->firstSegment = 0;
+    chainToAppend->lastSegment = 0;
+    chainToAppend->size = 0;
+    chainToAppend->segmentsCount = 0;
+
+    return chain;
+}
+
+static NVectorSize size(struct NByteChain* chain) {
+    return chain->size;
+}
+
+static NVectorSize segmentsCount(struct NByteChain* chain) {
+    return chain->segmentsCount;
+}
+
+static boolean appendToByteVector(struct NByteChain* chain, struct NByteVector* outputVector) {
+
+    if (!chain->size) return True;
+
+    // Reserve once, then copy segment by segment,
+    uint8_t* output = NByteVector_reserveWritable(outputVector, chain->size);
+    if (!output) return False;
+    for (struct NByteChainSegment* segment = chain->firstSegment; segment; segment = segment->next) {
+        NSystemUtils.memcpy(output, segment->data, segment->size);
+        output += segment->size;
+    }
+    return NByteVector_commit(outputVector, chain->size);
+}
+
+static boolean writeSegmentsToFile(struct NByteChain* chain, const char* filePath, boolean append) {
+
+    if (!NSystemUtils.writeToFile) {
+        NERROR("NByteChain.writeToFile()", "Writing to files isn't supported on this platform");
+        return False;
+    }
+
+    // An empty chain still creates (or truncates) the file,
+    if (!chain->size) return NSystemUtils.writeToFile(filePath, "", 0, append);
+
+    // A write per segment, splitting any that don't fit in a single write,
+    for (struct NByteChainSegment* segment = chain->firstSegment; segment; segment = segment->next) {
+        const uint8_t* data = segment->data;
+        NVectorSize remainingSize = segment->size;
+        while (remainingSize) {
+            uint32_t writeSize = (remainingSize > 0x40000000) ? 0x40000000 : (uint32_t) remainingSize;
+            if (!NSystemUtils.writeToFile(filePath, data, writeSize, append)) return False;
+            append = True;
+            data += writeSize;
+            remainingSize -= writeSize;
+        }
+    }
+    return True;
+}
+
+static boolean writeToFile(struct NByteChain* chain, const char* filePath, boolean append) {
+
+    // Backends without gathered writes get a write per segment,
+    if (!NSystemUtils.writeBuffersToFile) return writeSegmentsToFile(chain, filePath, append);
+
+    // List the segments as buffers, on the stack if they're few enough,
+    const void* stackBuffers[WRITE_STACK_BUFFERS_COUNT];
+    int64_t stackSizes[WRITE_STACK_BUFFERS_COUNT];
+    const void** buffers = stackBuffers;
+    int64_t* sizes = stackSizes;
+    if (chain->segmentsCount > WRITE_STACK_BUFFERS_COUNT) {
+        if (chain->segmentsCount > 0x7fffffff) {
+            NERROR("NByteChain.writeToFile()", "Too many segments: %s%ld", NTCOLOR(HIGHLIGHT), (int64_t) chain->segmentsCount);
+            return False;
+        }
+        buffers = NMALLOC(chain->segmentsCount * (int64_t) sizeof(void*), "NByteChain.writeToFile() buffers");
+        sizes = NMALLOC(chain->segmentsCount * (int64_t) sizeof(int64_t), "NByteChain.writeToFile() sizes");
+        if (!buffers || !sizes) {
+            if (buffers) NFREE(buffers, "NByteChain.writeToFile() buffers");
+            if (sizes) NFREE(sizes, "NByteChain.writeToFile() sizes");
+            return False;
+        }
+    }
+
+    int32_t buffersCount=0;
+    for (struct NByteChainSegment* segment = chain->firstSegment; segment; segment = segment->next) {
+        buffers[buffersCount] = segment->data;
+        sizes[buffersCount] = segment->size;
+        buffersCount++;
+    }
+
+    boolean success = NSystemUtils.writeBuffersToFile(filePath, buffers, sizes, buffersCount, append);
+
+    if (buffers != stackBuffers) {
+        NFREE(buffers, "NByteChain.writeToFile() buffers");
+        NFREE(sizes, "NByteChain.writeToFile() sizes");
+    }
+
+    return success;
+}
+
+const struct NByteChain_Interface NByteChain = {
+    .initialize = initialize,
+    .create = create,
+    .destroy = destroy,
+    .destroyAndFree = destroyAndFree,
+    .clear = clear,
+    .pushBack = pushBack,
+    .pushBackBulk = pushBackBulk,
+    .reserveWritable = reserveWritable,
+    .commit = commit,
+    .splice = splice,
+    .size = size,
+    .segmentsCount = segmentsCount,
+    .appendToByteVector = appendToByteVector,
+    .writeToFile = writeToFile
+};
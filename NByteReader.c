@@ -0,0 +1,92 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NByteReader.h>
+
+static struct NByteReader* initialize(struct NByteReader* outputReader, const void* data, NVectorSize dataSize) {
+    outputReader->start = data;
+    outputReader->current = data;
+    outputReader->end = outputReader->start + dataSize;
+    return outputReader;
+}
+
+static struct NByteReader* initializeFromVector(struct NByteReader* outputReader, struct NByteVector* vector) {
+    return initialize(outputReader, vector->objects, vector->size);
+}
+
+static NVectorSize remaining(struct NByteReader* reader) {
+    return NByteReader_remaining(reader);
+}
+
+static NVectorSize position(struct NByteReader* reader) {
+    return (NVectorSize) (reader->current - reader->start);
+}
+
+static boolean skip(struct NByteReader* reader, NVectorSize size) {
+    return NByteReader_skip(reader, size);
+}
+
+// Wrappers of the inline functions,
+#define READ_WRAPPER(Name, Type) \
+    static boolean read##Name(struct NByteReader* reader, Type* output) { return NByteReader_read##Name(reader, output); }
+
+READ_WRAPPER(U8, uint8_t)
+READ_WRAPPER(U16, uint16_t)
+READ_WRAPPER(U32, uint32_t)
+READ_WRAPPER(U64, uint64_t)
+READ_WRAPPER(Float, float)
+READ_WRAPPER(Double, double)
+READ_WRAPPER(U16BE, uint16_t)
+READ_WRAPPER(U32BE, uint32_t)
+READ_WRAPPER(U64BE, uint64_t)
+READ_WRAPPER(FloatBE, float)
+READ_WRAPPER(DoubleBE, double)
+READ_WRAPPER(Varint, uint64_t)
+
+static boolean readSignedVarint(struct NByteReader* reader, int64_t* output) {
+    uint64_t value;
+    if (!NByteReader_readVarint(reader, &value)) return False;
+    *output = NVarint_zigzagDecode(value);
+    return True;
+}
+
+static boolean readBytes(struct NByteReader* reader, NVectorSize size, const void** outputView) {
+    return NByteReader_readBytes(reader, size, outputView);
+}
+
+static boolean peekU8(struct NByteReader* reader, uint8_t* output) {
+    if (reader->current == reader->end) return False;
+    *output = *reader->current;
+    return True;
+}
+
+static boolean peekBytes(struct NByteReader* reader, NVectorSize size, const void** outputView) {
+    if (size > NByteReader_remaining(reader)) return False;
+    *outputView = reader->current;
+    return True;
+}
+
+const struct NByteReader_Interface NByteReader = {
+    .initialize = initialize,
+    .initializeFromVector = initializeFromVector,
+    .remaining = remaining,
+    .position = position,
+    .skip = skip,
+    .readU8 = readU8,
+    .readU16 = readU16,
+    .readU32 = readU32,
+    .readU64 = readU64,
+    .readFloat = readFloat,
+    .readDouble = readDouble,
+    .readU16BE = readU16BE,
+    .readU32BE = readU32BE,
+    .readU64BE = readU64BE,
+    .readFloatBE = readFloatBE,
+    .readDoubleBE = readDoubleBE,
+    .readVarint = readVarint,
+    .readSignedVarint = readSignedVarint,
+    .readBytes = readBytes,
+    .peekU8 = peekU8,
+    .peekBytes = peekBytes
+};
@@ -1,10 +1,12 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
 #include <NByteVector.h>
 #include <NSystemUtils.h>
 #include <NError.h>
 
-#define NBYTEVECTOR_BOUNDARY_CHECK 1
-
-static struct NByteVector* initialize(struct NByteVector* outputVector, uint32_t initialCapacity) {
+static struct NByteVector* initialize(struct NByteVector* outputVector, NVectorSize initialCapacity) {
 
     NSystemUtils.memset(outputVector, 0, sizeof(struct NByteVector));
 
@@ -18,13 +20,25 @@ static struct NByteVector* initialize(struct NByteVector* outputVector, uint32_t
     return outputVector;
 }
 
-static struct NByteVector* create(uint32_t initialCapacity) {
+static struct NByteVector* initializeWithBuffer(struct NByteVector* outputVector, void* buffer, NVectorSize bufferSize) {
+
+    NSystemUtils.memset(outputVector, 0, sizeof(struct NByteVector));
+
+    outputVector->capacity = bufferSize;
+    outputVector->size = 0;
+    outputVector->externalObjects = True;
+    outputVector->objects = buffer;
+
+    return outputVector;
+}
+
+static struct NByteVector* create(NVectorSize initialCapacity) {
     struct NByteVector* vector = NMALLOC(sizeof(struct NByteVector), "NByteVector.create() vector");
     return initialize(vector, initialCapacity);
 }
 
 static void destroy(struct NByteVector* vector) {
-    if (vector->objects) NFREE(vector->objects, "NByteVector.destroy() vector->objects");
+    if (vector->objects && !vector->externalObjects) NFREE(vector->objects, "NByteVector.destroy() vector->objects");
     NSystemUtils.memset(vector, 0, sizeof(struct NByteVector));
 }
 
@@ -38,99 +52,93 @@ static struct NByteVector* clear(struct NByteVector* vector) {
     return vector;
 }
 
-static boolean grow(struct NByteVector* vector, uint32_t newCapacity) {
+static struct NByteVector* setGrowthPolicy(struct NByteVector* vector, int32_t growthPolicy) {
+    vector->growthPolicy = growthPolicy;
+    return vector;
+}
+
+static boolean grow(struct NByteVector* vector, NVectorSize newCapacity) {
 
     if (newCapacity <= vector->capacity) return True;
 
-    void *newArray = NMALLOC(newCapacity, "NByteVector.grow() newArray");
-    if (!newArray) return False;
+    // Compared in 64bit, since NVectorSize may be 32bit,
+    uint64_t newCapacity64 = newCapacity;
+    if (newCapacity64 > NVECTOR_MAX_ALLOCATION_SIZE) return False;
 
-    if (vector->objects) {
+    // Move out of a user provided buffer,
+    if (vector->externalObjects) {
+        void *newArray = NMALLOC(newCapacity, "NByteVector.grow() vector->objects");
+        if (!newArray) return False;
         NSystemUtils.memcpy(newArray, vector->objects, vector->size);
-        NFREE(vector->objects, "NByteVector.grow() vector->objects");
-    }
-
-    vector->objects = newArray;
-    vector->capacity = newCapacity;
-
-    return True;
-}
 
-static boolean expand(struct NByteVector* vector) {
-    if (vector->capacity == 0) {
-        vector->objects = NMALLOC(4, "NByteVector.expand() vector->objects");    // It's a waste to allocate less than 1 word, this also makes
-                                                                                 // sure we can push 32bits after a single expansion.
-        if (!vector->objects) return False;
-        vector->capacity = 4;
+        vector->objects = newArray;
+        vector->capacity = newCapacity;
+        vector->externalObjects = False;
         return True;
     }
 
-    return grow(vector, vector->capacity<<1u);
-}
-
-static boolean pushBack(struct NByteVector* vector, uint8_t value) {
-
-    // Double the vector capacity if needed,
-    if ((vector->size == vector->capacity) && !expand(vector)) return False;
-
-    // Push the value,
-    vector->objects[vector->size++] = value;
-    return True;
-}
-
-static boolean popBack(struct NByteVector* vector, uint8_t *output) {
-    if (vector->size == 0) return False;
-
-    *output = vector->objects[--(vector->size)];
-    return True;
-}
-
-static boolean pushBack32Bit(struct NByteVector* vector, int32_t value) {
-
-    // Double the vector capacity if needed,
-    if ((vector->size + 4 > vector->capacity) && !expand(vector)) return False;
-
-    // Push the value,
-    // Note: TYPE PUNNING, could result in unaligned memory access. Maybe we should use memcopy
-    //       or define out own routine? See: https://en.wikipedia.org/wiki/Type_punning#Use_of_pointers
-    *((int32_t *) &vector->objects[vector->size]) = value;
-    vector->size += 4;
-    return True;
-}
+    // Reallocate. This grows the block in place whenever possible, avoiding the copy,
+    void *newArray = NREALLOC(vector->objects, newCapacity, "NByteVector.grow() vector->objects");
+    if (!newArray) return False;
 
-static boolean popBack32Bit(struct NByteVector* vector, int32_t *output) {
-    if (vector->size < 4) return False;
+    vector->objects = newArray;
+    vector->capacity = newCapacity;
 
-    vector->size -= 4;
-    *output = *((int32_t *) &vector->objects[vector->size]);
     return True;
 }
 
-static boolean ensureCapacity(struct NByteVector* vector, uint32_t additionalCapacity) {
+static boolean ensureCapacity(struct NByteVector* vector, NVectorSize additionalCapacity) {
 
     // Maybe we needn't do anything,
-    uint32_t requiredCapacity = vector->size + additionalCapacity;
+    NVectorSize requiredCapacity = vector->size + additionalCapacity;
+    if (requiredCapacity < additionalCapacity) return False; // Overflow.
     if (requiredCapacity <= vector->capacity) return True;
 
-    // Check if an expansion would do,
-    if (requiredCapacity <= (vector->capacity<<1u)) return expand(vector);
-
-    // Grow to the required size directly,
-    return grow(vector, requiredCapacity);
+    // Grow according to the growth policy,
+    NVectorSize newCapacity = NGrowthPolicy.getNewCapacity(vector->growthPolicy, vector->capacity, requiredCapacity, 1);
+    if (!newCapacity) return False;
+    if (newCapacity < 4) newCapacity = 4; // It's a waste to allocate less than 1 word, this also makes
+                                          // sure we can push 32bits after a single expansion.
+    return grow(vector, newCapacity);
 }
 
-static boolean pushBackBulk(struct NByteVector* vector, void* data, uint32_t size) {
+static boolean pushBack(struct NByteVector* vector, uint8_t value) {
+    return NByteVector_pushBack(vector, value);
+}
 
-    // Increase capacity if needed,
-    if (!ensureCapacity(vector, size)) return False;
+static boolean popBack(struct NByteVector* vector, uint8_t *output) {
+    return NByteVector_popBack(vector, output);
+}
 
-    // Push the block,
-    NSystemUtils.memcpy(&vector->objects[vector->size], data, size);
-    vector->size += size;
-    return True;
+// Wrappers of the typed inline functions,
+#define TYPED_WRAPPERS(Name, Type) \
+    static boolean pushBack##Name(struct NByteVector* vector, Type value) { return NByteVector_pushBack##Name(vector, value); } \
+    static boolean popBack##Name(struct NByteVector* vector, Type *output) { return NByteVector_popBack##Name(vector, output); } \
+    static boolean peek##Name(struct NByteVector* vector, Type *output) { return NByteVector_peek##Name(vector, output); }
+
+TYPED_WRAPPERS(16Bit, int16_t)
+TYPED_WRAPPERS(32Bit, int32_t)
+TYPED_WRAPPERS(64Bit, int64_t)
+TYPED_WRAPPERS(Float, float)
+TYPED_WRAPPERS(Double, double)
+
+TYPED_WRAPPERS(16BitLE, int16_t)
+TYPED_WRAPPERS(32BitLE, int32_t)
+TYPED_WRAPPERS(64BitLE, int64_t)
+TYPED_WRAPPERS(FloatLE, float)
+TYPED_WRAPPERS(DoubleLE, double)
+
+TYPED_WRAPPERS(16BitBE, int16_t)
+TYPED_WRAPPERS(32BitBE, int32_t)
+TYPED_WRAPPERS(64BitBE, int64_t)
+TYPED_WRAPPERS(FloatBE, float)
+TYPED_WRAPPERS(DoubleBE, double)
+
+static boolean pushBackBulk(struct NByteVector* vector, void* data, NVectorSize size) {
+    return NByteVector_pushBackBulk(vector, data, size);
 }
 
-static boolean popBackBulk(struct NByteVector* vector, void* outputData, uint32_t size) {
+static boolean popBackBulk(struct NByteVector* vector, void* outputData, NVectorSize size) {
 
     if (vector->size < size) return False;
 
@@ -139,10 +147,10 @@ static boolean popBackBulk(struct NByteVector* vector, void* outputData, uint32_
     return True;
 }
 
-static uint8_t get(struct NByteVector* vector, uint32_t index) {
+static uint8_t get(struct NByteVector* vector, NVectorSize index) {
 #if NBYTEVECTOR_BOUNDARY_CHECK
     if (index >= vector->size) {
-        NERROR("NByteVector.get()", "Index out of bound: %d", index);
+        NERROR("NByteVector.get()", "Index out of bound: %ld", (int64_t) index);
         return 0;
     }
 #endif
@@ -150,10 +158,10 @@ static uint8_t get(struct NByteVector* vector, uint32_t index) {
     return vector->objects[index];
 }
 
-static boolean set(struct NByteVector* vector, uint32_t index, uint8_t value) {
+static boolean set(struct NByteVector* vector, NVectorSize index, uint8_t value) {
 #if NBYTEVECTOR_BOUNDARY_CHECK
     if (index >= vector->size) {
-        NERROR("NByteVector.get()", "Index out of bound: %d", index);
+        NERROR("NByteVector.set()", "Index out of bound: %ld", (int64_t) index);
         return False;
     }
 #endif
@@ -162,16 +170,24 @@ static boolean set(struct NByteVector* vector, uint32_t index, uint8_t value) {
     return True;
 }
 
-static uint32_t size(struct NByteVector* vector) {
-    return vector->size;
+static NVectorSize size(struct NByteVector* vector) {
+    return NByteVector_size(vector);
 }
 
-static boolean resize(struct NByteVector* vector, uint32_t newSize) {
-    if (newSize > vector->capacity && !grow(vector, newSize)) return False;
+static boolean resize(struct NByteVector* vector, NVectorSize newSize) {
+    if ((newSize > vector->size) && !ensureCapacity(vector, newSize - vector->size)) return False;
     vector->size = newSize;
     return True;
 }
 
+static void* reserveWritable(struct NByteVector* vector, NVectorSize size) {
+    return NByteVector_reserveWritable(vector, size);
+}
+
+static boolean commit(struct NByteVector* vector, NVectorSize writtenSize) {
+    return NByteVector_commit(vector, writtenSize);
+}
+
 const struct NByteVector_Interface NByteVector = {
     .initialize = initialize,
     .create = create,
@@ -188,5 +204,58 @@ const struct NByteVector_Interface NByteVector = {
     .set = set,
     .size = size,
     .resize = resize,
-    .ensureCapacity = ensureCapacity
+    .ensureCapacity = ensureCapacity,
+    .setGrowthPolicy = setGrowthPolicy,
+    .initializeWithBuffer = initializeWithBuffer,
+    .pushBack16Bit = pushBack16Bit,
+    .popBack16Bit = popBack16Bit,
+    .peek16Bit = peek16Bit,
+    .peek32Bit = peek32Bit,
+    .pushBack64Bit = pushBack64Bit,
+    .popBack64Bit = popBack64Bit,
+    .peek64Bit = peek64Bit,
+    .pushBackFloat = pushBackFloat,
+    .popBackFloat = popBackFloat,
+    .peekFloat = peekFloat,
+    .pushBackDouble = pushBackDouble,
+    .popBackDouble = popBackDouble,
+    .peekDouble = peekDouble,
+    .reserveWritable = reserveWritable,
+    .commit = commit
+};
+
+const struct NByteVectorEndian_Interface NByteVectorLE = {
+    .pushBack16Bit = pushBack16BitLE,
+    .popBack16Bit = popBack16BitLE,
+    .peek16Bit = peek16BitLE,
+    .pushBack32Bit = pushBack32BitLE,
+    .popBack32Bit = popBack32BitLE,
+    .peek32Bit = peek32BitLE,
+    .pushBack64Bit = pushBack64BitLE,
+    .popBack64Bit = popBack64BitLE,
+    .peek64Bit = peek64BitLE,
+    .pushBackFloat = pushBackFloatLE,
+    .popBackFloat = popBackFloatLE,
+    .peekFloat = peekFloatLE,
+    .pushBackDouble = pushBackDoubleLE,
+    .popBackDouble = popBackDoubleLE,
+    .peekDouble = peekDoubleLE
+};
+
+const struct NByteVectorEndian_Interface NByteVectorBE = {
+    .pushBack16Bit = pushBack16BitBE,
+    .popBack16Bit = popBack16BitBE,
+    .peek16Bit = peek16BitBE,
+    .pushBack32Bit = pushBack32BitBE,
+    .popBack32Bit = popBack32BitBE,
+    .peek32Bit = peek32BitBE,
+    .pushBack64Bit = pushBack64BitBE,
+    .popBack64Bit = popBack64BitBE,
+    .peek64Bit = peek64BitBE,
+    .pushBackFloat = pushBackFloatBE,
+    .popBackFloat = popBackFloatBE,
+    .peekFloat = peekFloatBE,
+    .pushBackDouble = pushBackDoubleBE,
+    .popBackDouble = popBackDoubleBE,
+    .peekDouble = peekDoubleBE
 };
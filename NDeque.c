@@ -0,0 +1,206 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NDeque.h>
+#include <NSystemUtils.h>
+
+// Smallest power of 2 not less than value. 0 if not representable,
+static inline NVectorSize roundUpToPowerOf2(NVectorSize value) {
+    NVectorSize powerOf2=1;
+    while (powerOf2 < value) {
+        if (!(powerOf2 << 1)) return 0;
+        powerOf2 <<= 1;
+    }
+    return powerOf2;
+}
+
+static inline boolean isValidCapacity(NVectorSize capacity, uint32_t objectSize) {
+    return capacity <= NVECTOR_MAX_ALLOCATION_SIZE / objectSize;
+}
+
+static struct NDeque* initialize(struct NDeque* outputDeque, NVectorSize initialCapacity, uint32_t objectSize) {
+
+    if (objectSize==0) return 0;
+    if (initialCapacity > 0) {
+        initialCapacity = roundUpToPowerOf2(initialCapacity);
+        if (!initialCapacity || !isValidCapacity(initialCapacity, objectSize)) return 0;
+    }
+
+    NSystemUtils.memset(outputDeque, 0, sizeof(struct NDeque));
+
+    outputDeque->capacity = initialCapacity;
+    outputDeque->objectSize = objectSize;
+
+    if (initialCapacity > 0) outputDeque->objects = NMALLOC(initialCapacity * objectSize, "NDeque.initialize() outputDeque->objects");
+
+    return outputDeque;
+}
+
+static struct NDeque* create(NVectorSize initialCapacity, uint32_t objectSize) {
+
+    if (objectSize==0) return 0;
+
+    struct NDeque* newDeque = NMALLOC(sizeof(struct NDeque), "NDeque.create() newDeque");
+    if (!initialize(newDeque, initialCapacity, objectSize)) {
+        NFREE(newDeque, "NDeque.create() newDeque");
+        return 0;
+    }
+    return newDeque;
+}
+
+static void destroy(struct NDeque* deque) {
+    if (deque->objects) NFREE(deque->objects, "NDeque.destroy() deque->objects");
+    NSystemUtils.memset(deque, 0, sizeof(struct NDeque));
+}
+
+static void destroyAndFree(struct NDeque* deque) {
+    destroy(deque);
+    NFREE(deque, "NDeque.destroyAndFree() deque");
+}
+
+static struct NDeque* clear(struct NDeque* deque) {
+    deque->head = 0;
+    deque->objectsCount = 0;
+    return deque;
+}
+
+static boolean ensureCapacity(struct NDeque* deque, NVectorSize additionalCapacity) {
+
+    // Maybe we needn't do anything,
+    NVectorSize requiredCapacity = deque->objectsCount + additionalCapacity;
+    if (requiredCapacity < additionalCapacity) return False; // Overflow.
+    if (requiredCapacity <= deque->capacity) return True;
+
+    // Capacity must remain a power of 2. Start at 4 objects,
+    NVectorSize newCapacity = roundUpToPowerOf2(requiredCapacity < 4 ? 4 : requiredCapacity);
+    if (!newCapacity || !isValidCapacity(newCapacity, deque->objectSize)) return False;
+
+    // Reallocate. This grows the block in place whenever possible,
+    void *newArray = NREALLOC(deque->objects, newCapacity * (int64_t) deque->objectSize, "NDeque.ensureCapacity() deque->objects");
+    if (!newArray) return False;
+
+    // If the objects wrapped around, the wrapped part (at the array start) is moved right after the
+    // old end. The new capacity is at least double the old one, so it always fits,
+    NVectorSize oldCapacity = deque->capacity;
+    if (deque->head + deque->objectsCount > oldCapacity) {
+        NVectorSize wrappedCount = deque->head + deque->objectsCount - oldCapacity;
+        NSystemUtils.memcpy(
+                (void*) (((intptr_t) newArray) + (oldCapacity * deque->objectSize)),
+                newArray, wrappedCount * deque->objectSize);
+    }
+
+    deque->objects = newArray;
+    deque->capacity = newCapacity;
+
+    return True;
+}
+
+static boolean pushBack(struct NDeque* deque, const void* object) {
+    return NDeque_pushBack(deque, object);
+}
+
+static boolean pushFront(struct NDeque* deque, const void* object) {
+
+    // Expand the deque capacity if needed,
+    if ((deque->objectsCount == deque->capacity) && !ensureCapacity(deque, 1)) return False;
+
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->objectsCount++;
+    NSTDLIB_INLINE_MEMCPY(NDeque_getAddress(deque, 0), object, deque->objectSize);
+    return True;
+}
+
+static boolean popBack(struct NDeque* deque, void* outputObject) {
+    if (deque->objectsCount==0) return False;
+
+    deque->objectsCount--;
+    NSTDLIB_INLINE_MEMCPY(outputObject, NDeque_getAddress(deque, deque->objectsCount), deque->objectSize);
+    return True;
+}
+
+static boolean popFront(struct NDeque* deque, void* outputObject) {
+    return NDeque_popFront(deque, outputObject);
+}
+
+static boolean pushBackBulk(struct NDeque* deque, const void* objects, NVectorSize objectsCount) {
+
+    // Reserve once,
+    if (!ensureCapacity(deque, objectsCount)) return False;
+    if (!objectsCount) return True;
+
+    // Copy up to the array end, then the rest at the array start,
+    NVectorSize tail = (deque->head + deque->objectsCount) & (deque->capacity - 1);
+    NVectorSize firstPartCount = deque->capacity - tail;
+    if (firstPartCount > objectsCount) firstPartCount = objectsCount;
+
+    NSystemUtils.memcpy(NDeque_getAddress(deque, deque->objectsCount), objects, firstPartCount * deque->objectSize);
+    if (objectsCount > firstPartCount) {
+        NSystemUtils.memcpy(
+                deque->objects,
+                (void*) (((intptr_t) objects) + (firstPartCount * deque->objectSize)),
+                (objectsCount - firstPartCount) * deque->objectSize);
+    }
+    deque->objectsCount += objectsCount;
+
+    return True;
+}
+
+static boolean popFrontBulk(struct NDeque* deque, void* outputObjects, NVectorSize objectsCount) {
+
+    if (deque->objectsCount < objectsCount) return False;
+    if (!objectsCount) return True;
+
+    // Copy up to the array end, then the rest from the array start,
+    NVectorSize firstPartCount = deque->capacity - deque->head;
+    if (firstPartCount > objectsCount) firstPartCount = objectsCount;
+
+    NSystemUtils.memcpy(outputObjects, NDeque_getAddress(deque, 0), firstPartCount * deque->objectSize);
+    if (objectsCount > firstPartCount) {
+        NSystemUtils.memcpy(
+                (void*) (((intptr_t) outputObjects) + (firstPartCount * deque->objectSize)),
+                deque->objects,
+                (objectsCount - firstPartCount) * deque->objectSize);
+    }
+    deque->head = (deque->head + objectsCount) & (deque->capacity - 1);
+    deque->objectsCount -= objectsCount;
+
+    return True;
+}
+
+static void* get(struct NDeque* deque, NVectorSize index) {
+    return NDeque_get(deque, index);
+}
+
+static void* getFirst(struct NDeque* deque) {
+    if (!deque->objectsCount) return 0;
+    return NDeque_getAddress(deque, 0);
+}
+
+static void* getLast(struct NDeque* deque) {
+    if (!deque->objectsCount) return 0;
+    return NDeque_getAddress(deque, deque->objectsCount-1);
+}
+
+static NVectorSize size(struct NDeque* deque) {
+    return NDeque_size(deque);
+}
+
+const struct NDeque_Interface NDeque = {
+    .initialize = initialize,
+    .create = create,
+    .destroy = destroy,
+    .destroyAndFree = destroyAndFree,
+    .clear = clear,
+    .ensureCapacity = ensureCapacity,
+    .pushBack = pushBack,
+    .pushFront = pushFront,
+    .popBack = popBack,
+    .popFront = popFront,
+    .pushBackBulk = pushBackBulk,
+    .popFrontBulk = popFrontBulk,
+    .get = get,
+    .getFirst = getFirst,
+    .getLast = getLast,
+    .size = size
+};
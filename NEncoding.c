@@ -0,0 +1,479 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NEncoding.h>
+#include <NSystemUtils.h>
+#include <NError.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define NENCODING_X86_SIMD 1
+    #include <immintrin.h>
+#else
+    #define NENCODING_X86_SIMD 0
+#endif
+
+// SIMD kernels may write up to this many bytes past the output they produce,
+#define OUTPUT_SLACK 32
+
+static const char hexDigits[] = "0123456789abcdef";
+static const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char base64UrlAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// Character values (-1 if invalid) for the scalar decoders, generated on first use,
+static int8_t hexValues[256];
+static int8_t base64Values[256];
+static int8_t base64UrlValues[256];
+static boolean tablesGenerated=False;
+
+static void generateTables() {
+    for (int32_t i=0; i<256; i++) {
+        hexValues[i] = base64Values[i] = base64UrlValues[i] = -1;
+    }
+    for (int32_t i=0; i<16; i++) {
+        hexValues[(uint8_t) hexDigits[i]] = i;
+        if (i >= 10) hexValues[(uint8_t) hexDigits[i] - 32] = i; // Uppercase.
+    }
+    for (int32_t i=0; i<64; i++) {
+        base64Values[(uint8_t) base64Alphabet[i]] = i;
+        base64UrlValues[(uint8_t) base64UrlAlphabet[i]] = i;
+    }
+    tablesGenerated = True;
+}
+
+static int32_t simdLevel=-1;
+static inline int32_t getSIMDLevel() {
+    if (simdLevel < 0) {
+        #if NENCODING_X86_SIMD
+            __builtin_cpu_init();
+            simdLevel = __builtin_cpu_supports("avx2") ? 2 : (__builtin_cpu_supports("ssse3") ? 1 : 0);
+        #else
+            simdLevel = 0;
+        #endif
+    }
+    return simdLevel;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// SIMD kernels
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Kernels process whole blocks only, and return the consumed input size. Decoders stop at the
+// first block containing an invalid character, leaving it to the scalar code to report it.
+
+#if NENCODING_X86_SIMD
+
+// Hex encoding. Every nibble indexes the digits table through a byte shuffle,
+__attribute__((target("ssse3")))
+static NVectorSize hexEncodeSSSE3(const uint8_t* input, NVectorSize size, char* output) {
+    const __m128i digits = _mm_loadu_si128((const __m128i*) hexDigits);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    NVectorSize i=0;
+    for (; i+16 <= size; i+=16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) &input[i]);
+        __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask));
+        __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibbleMask));
+        _mm_storeu_si128((__m128i*) &output[i*2   ], _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i*) &output[i*2+16], _mm_unpackhi_epi8(high, low));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static NVectorSize hexEncodeAVX2(const uint8_t* input, NVectorSize size, char* output) {
+    const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) hexDigits));
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    NVectorSize i=0;
+    for (; i+32 <= size; i+=32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*) &input[i]);
+        __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask));
+        __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibbleMask));
+
+        // Unpacking works within lanes, restore the order,
+        __m256i first = _mm256_unpacklo_epi8(high, low);
+        __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256((__m256i*) &output[i*2   ], _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i*) &output[i*2+32], _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+// Hex decoding. Converts 16 characters into nibbles, and packs them into 8 bytes (in the low
+// half of every 16bit element). Clears the valid mask bits of invalid characters,
+__attribute__((target("ssse3")))
+static inline __m128i hexDecode16SSSE3(__m128i characters, __m128i* validMask) {
+    __m128i digit = _mm_sub_epi8(characters, _mm_set1_epi8('0'));
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(characters, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    *validMask = _mm_and_si128(*validMask, _mm_or_si128(isDigit, isLetter));
+
+    __m128i nibbles = _mm_or_si128(
+            _mm_and_si128(isDigit, digit),
+            _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+    return _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110)); // high*16 + low.
+}
+
+__attribute__((target("ssse3")))
+static NVectorSize hexDecodeSSSE3(const char* input, NVectorSize length, uint8_t* output) {
+    NVectorSize i=0;
+    for (; i+32 <= length; i+=32) {
+        __m128i validMask = _mm_set1_epi8(-1);
+        __m128i first = hexDecode16SSSE3(_mm_loadu_si128((const __m128i*) &input[i]), &validMask);
+        __m128i second = hexDecode16SSSE3(_mm_loadu_si128((const __m128i*) &input[i+16]), &validMask);
+        if (_mm_movemask_epi8(validMask) != 0xffff) break;
+        _mm_storeu_si128((__m128i*) &output[i/2], _mm_packus_epi16(first, second));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i hexDecode32AVX2(__m256i characters, __m256i* validMask) {
+    __m256i digit = _mm256_sub_epi8(characters, _mm256_set1_epi8('0'));
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(characters, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    *validMask = _mm256_and_si256(*validMask, _mm256_or_si256(isDigit, isLetter));
+
+    __m256i nibbles = _mm256_or_si256(
+            _mm256_and_si256(isDigit, digit),
+            _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+    return _mm256_maddubs_epi16(nibbles, _mm256_set1_epi16(0x0110));
+}
+
+__attribute__((target("avx2")))
+static NVectorSize hexDecodeAVX2(const char* input, NVectorSize length, uint8_t* output) {
+    NVectorSize i=0;
+    for (; i+64 <= length; i+=64) {
+        __m256i validMask = _mm256_set1_epi8(-1);
+        __m256i first = hexDecode32AVX2(_mm256_loadu_si256((const __m256i*) &input[i]), &validMask);
+        __m256i second = hexDecode32AVX2(_mm256_loadu_si256((const __m256i*) &input[i+32]), &validMask);
+        if (_mm256_movemask_epi8(validMask) != -1) break;
+
+        // Packing works within lanes, restore the order,
+        __m256i packed = _mm256_packus_epi16(first, second);
+        _mm256_storeu_si256((__m256i*) &output[i/2], _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+    return i;
+}
+
+// Base64 encoding. See: http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+//
+// Spreads every 3 bytes over 4 bytes, and splits them into 6bit indices, then maps the indices
+// to characters by adding an offset that depends on the index range,
+#define BASE64_ENCODE_KERNEL(BITS, PREFIX, SUFFIX) \
+    { \
+        /* Bytes (a, b, c) become (b, a, c, b), so every 6bit index fits in a 16bit element, */ \
+        bytes = PREFIX##_shuffle_epi8(bytes, spreadShuffle); \
+        __m##BITS##i indices = PREFIX##_or_si##SUFFIX( \
+                PREFIX##_mulhi_epu16(PREFIX##_and_si##SUFFIX(bytes, PREFIX##_set1_epi32(0x0fc0fc00)), PREFIX##_set1_epi32(0x04000040)), \
+                PREFIX##_mullo_epi16(PREFIX##_and_si##SUFFIX(bytes, PREFIX##_set1_epi32(0x003f03f0)), PREFIX##_set1_epi32(0x01000010))); \
+        \
+        /* Range index: 0 for [0, 25] (letters), 13 for [26, 51], 1..12 for [52, 63], */ \
+        __m##BITS##i range = PREFIX##_subs_epu8(indices, PREFIX##_set1_epi8(51)); \
+        range = PREFIX##_or_si##SUFFIX(range, PREFIX##_and_si##SUFFIX(PREFIX##_cmpgt_epi8(PREFIX##_set1_epi8(26), indices), PREFIX##_set1_epi8(13))); \
+        characters = PREFIX##_add_epi8(indices, PREFIX##_shuffle_epi8(offsets, range)); \
+    }
+
+__attribute__((target("ssse3")))
+static NVectorSize base64EncodeSSSE3(const uint8_t* input, NVectorSize size, char* output, const char* alphabet) {
+    const __m128i spreadShuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m128i offsets = _mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, alphabet[62] - 62, alphabet[63] - 63, 'A', 0, 0);
+
+    // Reads 16 bytes, consumes 12,
+    NVectorSize i=0, o=0;
+    for (; i+16 <= size; i+=12, o+=16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) &input[i]);
+        __m128i characters;
+        BASE64_ENCODE_KERNEL(128, _mm, 128)
+        _mm_storeu_si128((__m128i*) &output[o], characters);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static NVectorSize base64EncodeAVX2(const uint8_t* input, NVectorSize size, char* output, const char* alphabet) {
+    const __m256i spreadShuffle = _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i offsets = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, alphabet[62] - 62, alphabet[63] - 63, 'A', 0, 0));
+
+    // Every lane gets 12 bytes. Reads 28 bytes, consumes 24,
+    NVectorSize i=0, o=0;
+    for (; i+28 <= size; i+=24, o+=32) {
+        __m256i bytes = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) &input[i])),
+                _mm_loadu_si128((const __m128i*) &input[i+12]), 1);
+        __m256i characters;
+        BASE64_ENCODE_KERNEL(256, _mm256, 256)
+        _mm256_storeu_si256((__m256i*) &output[o], characters);
+    }
+    return i;
+}
+
+// Base64 decoding. See: http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+//
+// Maps characters to their 6bit values by adding an offset that depends on the character range,
+// then merges every 4 values into 3 bytes,
+#define BASE64_DECODE_KERNEL(BITS, PREFIX, SUFFIX) \
+    { \
+        __m##BITS##i isUpper = PREFIX##_and_si##SUFFIX(PREFIX##_cmpgt_epi8(characters, PREFIX##_set1_epi8('A' - 1)), PREFIX##_cmpgt_epi8(PREFIX##_set1_epi8('Z' + 1), characters)); \
+        __m##BITS##i isLower = PREFIX##_and_si##SUFFIX(PREFIX##_cmpgt_epi8(characters, PREFIX##_set1_epi8('a' - 1)), PREFIX##_cmpgt_epi8(PREFIX##_set1_epi8('z' + 1), characters)); \
+        __m##BITS##i isDigit = PREFIX##_and_si##SUFFIX(PREFIX##_cmpgt_epi8(characters, PREFIX##_set1_epi8('0' - 1)), PREFIX##_cmpgt_epi8(PREFIX##_set1_epi8('9' + 1), characters)); \
+        __m##BITS##i is62 = PREFIX##_cmpeq_epi8(characters, PREFIX##_set1_epi8(alphabet[62])); \
+        __m##BITS##i is63 = PREFIX##_cmpeq_epi8(characters, PREFIX##_set1_epi8(alphabet[63])); \
+        valid = PREFIX##_or_si##SUFFIX(PREFIX##_or_si##SUFFIX(PREFIX##_or_si##SUFFIX(isUpper, isLower), PREFIX##_or_si##SUFFIX(isDigit, is62)), is63); \
+        \
+        __m##BITS##i offset = PREFIX##_or_si##SUFFIX( \
+                PREFIX##_or_si##SUFFIX(PREFIX##_and_si##SUFFIX(isUpper, PREFIX##_set1_epi8(-'A')), PREFIX##_and_si##SUFFIX(isLower, PREFIX##_set1_epi8(26 - 'a'))), \
+                PREFIX##_or_si##SUFFIX(PREFIX##_and_si##SUFFIX(isDigit, PREFIX##_set1_epi8(52 - '0')), \
+                        PREFIX##_or_si##SUFFIX(PREFIX##_and_si##SUFFIX(is62, PREFIX##_set1_epi8(62 - alphabet[62])), PREFIX##_and_si##SUFFIX(is63, PREFIX##_set1_epi8(63 - alphabet[63]))))); \
+        __m##BITS##i values = PREFIX##_add_epi8(characters, offset); \
+        \
+        /* (a, b, c, d) -> (a*64 + b, c*64 + d) -> ((a*64 + b)*4096 + c*64 + d), then big endian to bytes, */ \
+        values = PREFIX##_maddubs_epi16(values, PREFIX##_set1_epi32(0x01400140)); \
+        values = PREFIX##_madd_epi16(values, PREFIX##_set1_epi32(0x00011000)); \
+        bytes = PREFIX##_shuffle_epi8(values, packShuffle); \
+    }
+
+__attribute__((target("ssse3")))
+static NVectorSize base64DecodeSSSE3(const char* input, NVectorSize length, uint8_t* output, const char* alphabet) {
+    const __m128i packShuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    // Consumes 16 characters, writes 16 bytes (12 decoded),
+    NVectorSize i=0, o=0;
+    for (; i+16 <= length; i+=16, o+=12) {
+        __m128i characters = _mm_loadu_si128((const __m128i*) &input[i]);
+        __m128i valid, bytes;
+        BASE64_DECODE_KERNEL(128, _mm, 128)
+        if (_mm_movemask_epi8(valid) != 0xffff) break;
+        _mm_storeu_si128((__m128i*) &output[o], bytes);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static NVectorSize base64DecodeAVX2(const char* input, NVectorSize length, uint8_t* output, const char* alphabet) {
+    const __m256i packShuffle = _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i compactPermutation = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+    // Consumes 32 characters, writes 32 bytes (24 decoded),
+    NVectorSize i=0, o=0;
+    for (; i+32 <= length; i+=32, o+=24) {
+        __m256i characters = _mm256_loadu_si256((const __m256i*) &input[i]);
+        __m256i valid, bytes;
+        BASE64_DECODE_KERNEL(256, _mm256, 256)
+        if (_mm256_movemask_epi8(valid) != -1) break;
+        _mm256_storeu_si256((__m256i*) &output[o], _mm256_permutevar8x32_epi32(bytes, compactPermutation));
+    }
+    return i;
+}
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Hex
+/////////////////////////////////////////////////////////////////////////////////////
+
+static NVectorSize hexEncodedSize(NVectorSize size) {
+    return size * 2;
+}
+
+static boolean hexEncode(const void* data, NVectorSize size, struct NString* outString) {
+    char* output = NString_reserveWritable(outString, size*2 + OUTPUT_SLACK);
+    if (!output) return False;
+
+    const uint8_t* input = data;
+    NVectorSize i=0;
+    #if NENCODING_X86_SIMD
+        switch (getSIMDLevel()) {
+            case 2: i = hexEncodeAVX2(input, size, output); break;
+            case 1: i = hexEncodeSSSE3(input, size, output); break;
+        }
+    #endif
+    for (; i<size; i++) {
+        output[i*2  ] = hexDigits[input[i] >> 4];
+        output[i*2+1] = hexDigits[input[i] & 15];
+    }
+
+    return NString_commit(outString, size*2);
+}
+
+static boolean hexEncodeByteVector(struct NByteVector* vector, struct NString* outString) {
+    return hexEncode(vector->objects, vector->size, outString);
+}
+
+static boolean hexDecode(const char* text, NVectorSize length, struct NByteVector* output) {
+    if (length & 1) {
+        NERROR("NEncoding.hexDecode()", "Odd text length: %s%ld", NTCOLOR(HIGHLIGHT), (int64_t) length);
+        return False;
+    }
+
+    uint8_t* destination = NByteVector_reserveWritable(output, length/2);
+    if (!destination && length) return False;
+
+    NVectorSize i=0;
+    #if NENCODING_X86_SIMD
+        switch (getSIMDLevel()) {
+            case 2: i = hexDecodeAVX2(text, length, destination); break;
+            case 1: i = hexDecodeSSSE3(text, length, destination); break;
+        }
+    #endif
+    if (!tablesGenerated) generateTables();
+    for (; i<length; i+=2) {
+        int32_t high = hexValues[(uint8_t) text[i]];
+        int32_t low = hexValues[(uint8_t) text[i+1]];
+        if ((high | low) < 0) {
+            NVectorSize invalidIndex = (high < 0) ? i : i+1;
+            NERROR("NEncoding.hexDecode()", "Invalid character at index %s%ld", NTCOLOR(HIGHLIGHT), (int64_t) invalidIndex);
+            return False;
+        }
+        destination[i/2] = (uint8_t) ((high << 4) | low);
+    }
+
+    return NByteVector_commit(output, length/2);
+}
+
+static boolean hexDecodeString(struct NString* string, struct NByteVector* output) {
+    return hexDecode(NString_get(string), NString_length(string), output);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Base64
+/////////////////////////////////////////////////////////////////////////////////////
+
+static NVectorSize base64EncodedSize(NVectorSize size, boolean urlSafe) {
+    if (urlSafe) return (size / 3) * 4 + ((size % 3) ? (size % 3) + 1 : 0);
+    return ((size + 2) / 3) * 4;
+}
+
+static boolean base64Encode(const void* data, NVectorSize size, struct NString* outString, boolean urlSafe) {
+    NVectorSize encodedSize = base64EncodedSize(size, urlSafe);
+    char* output = NString_reserveWritable(outString, encodedSize + OUTPUT_SLACK);
+    if (!output) return False;
+
+    const uint8_t* input = data;
+    const char* alphabet = urlSafe ? base64UrlAlphabet : base64Alphabet;
+    NVectorSize i=0;
+    #if NENCODING_X86_SIMD
+        switch (getSIMDLevel()) {
+            case 2: i = base64EncodeAVX2(input, size, output, alphabet); break;
+            case 1: i = base64EncodeSSSE3(input, size, output, alphabet); break;
+        }
+    #endif
+    char* currentOutput = output + (i / 3) * 4;
+    for (; i+3 <= size; i+=3) {
+        uint32_t bits = (input[i] << 16) | (input[i+1] << 8) | input[i+2];
+        currentOutput[0] = alphabet[ bits >> 18      ];
+        currentOutput[1] = alphabet[(bits >> 12) & 63];
+        currentOutput[2] = alphabet[(bits >>  6) & 63];
+        currentOutput[3] = alphabet[ bits        & 63];
+        currentOutput += 4;
+    }
+
+    // Remaining 1 or 2 bytes,
+    NVectorSize remaining = size - i;
+    if (remaining) {
+        uint32_t bits = (input[i] << 16) | ((remaining == 2) ? (input[i+1] << 8) : 0);
+        *currentOutput++ = alphabet[ bits >> 18      ];
+        *currentOutput++ = alphabet[(bits >> 12) & 63];
+        if (remaining == 2) {
+            *currentOutput++ = alphabet[(bits >> 6) & 63];
+        } else if (!urlSafe) {
+            *currentOutput++ = '=';
+        }
+        if (!urlSafe) *currentOutput++ = '=';
+    }
+
+    return NString_commit(outString, encodedSize);
+}
+
+static boolean base64EncodeByteVector(struct NByteVector* vector, struct NString* outString, boolean urlSafe) {
+    return base64Encode(vector->objects, vector->size, outString, urlSafe);
+}
+
+static boolean base64Decode(const char* text, NVectorSize length, struct NByteVector* output, boolean urlSafe) {
+
+    // Padding is optional. If present, the text must be a whole number of quads,
+    if (length && (text[length-1] == '=')) {
+        if (length & 3) goto invalidLength;
+        length -= (text[length-2] == '=') ? 2 : 1;
+    }
+    if ((length & 3) == 1) goto invalidLength;
+
+    NVectorSize decodedSize = (length / 4) * 3 + (((length & 3) * 3) / 4);
+    uint8_t* destination = NByteVector_reserveWritable(output, decodedSize + OUTPUT_SLACK);
+    if (!destination) return False;
+
+    const char* alphabet = urlSafe ? base64UrlAlphabet : base64Alphabet;
+    NVectorSize i=0;
+    #if NENCODING_X86_SIMD
+        switch (getSIMDLevel()) {
+            case 2: i = base64DecodeAVX2(text, length, destination, alphabet); break;
+            case 1: i = base64DecodeSSSE3(text, length, destination, alphabet); break;
+        }
+    #endif
+
+    // Remaining characters, a quad at a time,
+    if (!tablesGenerated) generateTables();
+    const int8_t* values = urlSafe ? base64UrlValues : base64Values;
+    uint8_t* currentOutput = destination + (i / 4) * 3;
+    for (; i+4 <= length; i+=4) {
+        int32_t a = values[(uint8_t) text[i  ]];
+        int32_t b = values[(uint8_t) text[i+1]];
+        int32_t c = values[(uint8_t) text[i+2]];
+        int32_t d = values[(uint8_t) text[i+3]];
+        if ((a | b | c | d) < 0) goto invalidCharacter;
+        uint32_t bits = (a << 18) | (b << 12) | (c << 6) | d;
+        currentOutput[0] = (uint8_t) (bits >> 16);
+        currentOutput[1] = (uint8_t) (bits >>  8);
+        currentOutput[2] = (uint8_t)  bits;
+        currentOutput += 3;
+    }
+
+    // Last partial quad,
+    if (i < length) {
+        int32_t a = values[(uint8_t) text[i  ]];
+        int32_t b = values[(uint8_t) text[i+1]];
+        int32_t c = (length - i == 3) ? values[(uint8_t) text[i+2]] : 0;
+        if ((a | b | c) < 0) goto invalidCharacter;
+        uint32_t bits = (a << 18) | (b << 12) | (c << 6);
+        currentOutput[0] = (uint8_t) (bits >> 16);
+        if (length - i == 3) currentOutput[1] = (uint8_t) (bits >> 8);
+    }
+
+    return NByteVector_commit(output, decodedSize);
+
+    invalidCharacter:
+    // Find it (only once, no per-byte overhead on the happy path),
+    while (values[(uint8_t) text[i]] >= 0) i++;
+    NERROR("NEncoding.base64Decode()", "Invalid character at index %s%ld", NTCOLOR(HIGHLIGHT), (int64_t) i);
+    return False;
+
+    invalidLength:
+    NERROR("NEncoding.base64Decode()", "Invalid text length: %s%ld", NTCOLOR(HIGHLIGHT), (int64_t) length);
+    return False;
+}
+
+static boolean base64DecodeString(struct NString* string, struct NByteVector* output, boolean urlSafe) {
+    return base64Decode(NString_get(string), NString_length(string), output, urlSafe);
+}
+
+const struct NEncoding_Interface NEncoding = {
+    .hexEncodedSize = hexEncodedSize,
+    .hexEncode = hexEncode,
+    .hexEncodeByteVector = hexEncodeByteVector,
+    .hexDecode = hexDecode,
+    .hexDecodeString = hexDecodeString,
+    .base64EncodedSize = base64EncodedSize,
+    .base64Encode = base64Encode,
+    .base64EncodeByteVector = base64EncodeByteVector,
+    .base64Decode = base64Decode,
+    .base64DecodeString = base64DecodeString
+};
@@ -1,38 +1,42 @@
 #include <NError.h>
 #include <NVector.h>
+#include <NSegmentedVector.h>
 #include <NSystemUtils.h>
 #include <NString.h>
 
-static struct NVector* errorsStack;
+// Errors are kept in a segmented vector, so pushing new errors never moves the existing ones,
+static struct NSegmentedVector* errorsStack;
 
 static void initialize() {
-    errorsStack = NVector.create(0, sizeof(struct NError));
+    errorsStack = NSegmentedVector.create(0, sizeof(struct NError));
 }
 
 static void terminate() {
     if (!errorsStack) return ;
-    NVector.destroyAndFree(errorsStack);
+    NSegmentedVector.destroyAndFree(errorsStack);
     errorsStack = 0;
 }
 
 static int32_t observeErrors() {
     if (!errorsStack) return 0;
-    return NVector.size(errorsStack);
+    return NSegmentedVector.size(errorsStack);
 }
 
 static struct NError* vPushError(const char* tag, const char* errorMessageFormat, va_list vaList) {
     if (!errorsStack) initialize();
 
-    // Create the error message,
-    struct NString* errorMessageString = NString.create("");
-    NString.vAppend(errorMessageString, errorMessageFormat, vaList);
-    // Note: vAppend could throw an error, which accordingly preserves and new error
-    // instance in the stack. If the stack is not large enough, it will be reallocated,
-    // and ALL the pointers that were once pointing to instances in the stack will
-    // become invalid. Thus, we create the error instance AFTER the vAppend() call.
+    // Create the error message. Messages that fit the error instance don't touch the heap,
+    char errorMessageBuffer[NERROR_MAX_MESSAGE_LENGTH];
+    struct NString errorMessageString;
+    NString.initializeWithBuffer(&errorMessageString, errorMessageBuffer, NERROR_MAX_MESSAGE_LENGTH, "");
+    NString.vAppend(&errorMessageString, errorMessageFormat, vaList);
+    // Note: vAppend could throw an error, which accordingly pushes a new error instance
+    // in the stack. The stack never moves its instances, so pointers to them remain
+    // valid. Still, we create the error instance AFTER the vAppend() call, so that it
+    // ends up above the errors it caused.
 
     // Create a new error in the stack,
-    struct NError* newError = NVector.emplaceBack(errorsStack);
+    struct NError* newError = NSegmentedVector.emplaceBack(errorsStack);
 
     // Copy the tag,
     int32_t charIndex=0;
@@ -49,15 +53,15 @@ static struct NError* vPushError(const char* tag, const char* errorMessageFormat
     newError->tag[charIndex] = 0;
 
     // Copy the message,
-    int32_t messageLength = NString.length(errorMessageString);
+    int32_t messageLength = NString.length(&errorMessageString);
     if (messageLength >= NERROR_MAX_MESSAGE_LENGTH) {
-        NSystemUtils.memcpy(newError->message, NString.get(errorMessageString), NERROR_MAX_MESSAGE_LENGTH-1);
+        NSystemUtils.memcpy(newError->message, NString.get(&errorMessageString), NERROR_MAX_MESSAGE_LENGTH-1);
         newError->message[NERROR_MAX_MESSAGE_LENGTH-1] = 0;
         NERROR("NError", "Error message exceeded maximum length");
     } else {
-        NSystemUtils.memcpy(newError->message, NString.get(errorMessageString), messageLength+1);
+        NSystemUtils.memcpy(newError->message, NString.get(&errorMessageString), messageLength+1);
     }
-    NString.destroyAndFree(errorMessageString);
+    NString.destroy(&errorMessageString);
 
     NTime.getTime(&(newError->time));
 
@@ -86,14 +90,14 @@ static struct NVector* popErrors(int32_t stackPosition) {
     if (!errorsStack) return 0;
 
     // If no errors, return immediately,
-    int32_t errorsCount = NVector.size(errorsStack) - stackPosition;
+    int32_t errorsCount = NSegmentedVector.size(errorsStack) - stackPosition;
     if (errorsCount <= 0) return 0;
 
     // Pop the errors and return them,
     struct NVector* errors = NVector.create(errorsCount, sizeof(struct NError));
     for (int32_t i=0; i<errorsCount; i++) {
         void* error = NVector.emplaceBack(errors);
-        NVector.popBack(errorsStack, error);
+        NSegmentedVector.popBack(errorsStack, error);
     }
 
     return errors;
@@ -0,0 +1,38 @@
+#include <NGrowthPolicy.h>
+
+static NVectorSize getNewCapacity(int32_t growthPolicy, NVectorSize currentCapacity, NVectorSize requiredCapacity, uint32_t objectSize) {
+
+    // The largest capacity whose size in bytes can be represented,
+    NVectorSize maxCapacity = NVECTOR_MAX_ALLOCATION_SIZE / objectSize;
+    if (requiredCapacity > maxCapacity) return 0;
+
+    // Note: all the computations below are checked against maxCapacity first to avoid overflows,
+    NVectorSize newCapacity;
+    if (growthPolicy == NGrowthPolicy.EXACT) {
+        newCapacity = requiredCapacity;
+    } else if ((growthPolicy == NGrowthPolicy.ONE_AND_A_HALF) || (growthPolicy == NGrowthPolicy.PAGE_ROUNDED)) {
+        newCapacity = (currentCapacity > maxCapacity - (currentCapacity>>1)) ? maxCapacity : currentCapacity + (currentCapacity>>1);
+    } else {
+        newCapacity = (currentCapacity > (maxCapacity>>1)) ? maxCapacity : currentCapacity<<1;
+    }
+    if (newCapacity < requiredCapacity) newCapacity = requiredCapacity;
+
+    // Round up to whole pages,
+    if (growthPolicy == NGrowthPolicy.PAGE_ROUNDED) {
+        uint64_t sizeBytes = (uint64_t) newCapacity * objectSize;
+        if (sizeBytes <= NVECTOR_MAX_ALLOCATION_SIZE - (NGROWTH_POLICY_PAGE_SIZE - 1)) {
+            sizeBytes = (sizeBytes + NGROWTH_POLICY_PAGE_SIZE - 1) & ~((uint64_t) NGROWTH_POLICY_PAGE_SIZE - 1);
+            newCapacity = sizeBytes / objectSize;
+        }
+    }
+
+    return newCapacity;
+}
+
+const struct NGrowthPolicy NGrowthPolicy = {
+    .DOUBLE = 0,
+    .ONE_AND_A_HALF = 1,
+    .EXACT = 2,
+    .PAGE_ROUNDED = 3,
+    .getNewCapacity = getNewCapacity
+};
@@ -0,0 +1,282 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NHash.h>
+#include <NSystemUtils.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define NHASH_X86_SIMD 1
+    #include <immintrin.h>
+#else
+    #define NHASH_X86_SIMD 0
+#endif
+
+// Little-endian loads, safe for unaligned addresses,
+static inline uint64_t read64(const uint8_t* data) {
+    uint64_t value;
+    NSTDLIB_INLINE_MEMCPY(&value, data, 8);
+    return NBYTEVECTOR_LE_SWAP64(value);
+}
+
+static inline uint32_t read32(const uint8_t* data) {
+    uint32_t value;
+    NSTDLIB_INLINE_MEMCPY(&value, data, 4);
+    return NBYTEVECTOR_LE_SWAP32(value);
+}
+
+static inline uint64_t rotateLeft64(uint64_t value, int32_t bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// XXH64
+/////////////////////////////////////////////////////////////////////////////////////
+
+// See: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t xxh64Round(uint64_t accumulator, uint64_t lane) {
+    accumulator += lane * PRIME64_2;
+    accumulator  = rotateLeft64(accumulator, 31);
+    return accumulator * PRIME64_1;
+}
+
+static inline uint64_t xxh64MergeAccumulator(uint64_t hash, uint64_t accumulator) {
+    hash ^= xxh64Round(0, accumulator);
+    return hash * PRIME64_1 + PRIME64_4;
+}
+
+static inline void xxh64InitializeAccumulators(uint64_t* accumulators, uint64_t seed) {
+    accumulators[0] = seed + PRIME64_1 + PRIME64_2;
+    accumulators[1] = seed + PRIME64_2;
+    accumulators[2] = seed;
+    accumulators[3] = seed - PRIME64_1;
+}
+
+// Consumes whole 32 bytes stripes. Returns the consumed size,
+static inline NVectorSize xxh64ConsumeStripes(uint64_t* accumulators, const uint8_t* data, NVectorSize size) {
+    uint64_t accumulator1 = accumulators[0], accumulator2 = accumulators[1];
+    uint64_t accumulator3 = accumulators[2], accumulator4 = accumulators[3];
+    NVectorSize offset=0;
+    for (; offset+32 <= size; offset+=32) {
+        accumulator1 = xxh64Round(accumulator1, read64(&data[offset     ]));
+        accumulator2 = xxh64Round(accumulator2, read64(&data[offset +  8]));
+        accumulator3 = xxh64Round(accumulator3, read64(&data[offset + 16]));
+        accumulator4 = xxh64Round(accumulator4, read64(&data[offset + 24]));
+    }
+    accumulators[0] = accumulator1; accumulators[1] = accumulator2;
+    accumulators[2] = accumulator3; accumulators[3] = accumulator4;
+    return offset;
+}
+
+static inline uint64_t xxh64MergeAccumulators(const uint64_t* accumulators) {
+    uint64_t hash =
+            rotateLeft64(accumulators[0],  1) + rotateLeft64(accumulators[1],  7) +
+            rotateLeft64(accumulators[2], 12) + rotateLeft64(accumulators[3], 18);
+    for (int32_t i=0; i<4; i++) hash = xxh64MergeAccumulator(hash, accumulators[i]);
+    return hash;
+}
+
+// Mixes the remaining (less than 32) bytes, and avalanches,
+static inline uint64_t xxh64Finish(uint64_t hash, const uint8_t* data, NVectorSize size) {
+    NVectorSize offset=0;
+    for (; offset+8 <= size; offset+=8) {
+        hash ^= xxh64Round(0, read64(&data[offset]));
+        hash  = rotateLeft64(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (offset+4 <= size) {
+        hash ^= ((uint64_t) read32(&data[offset])) * PRIME64_1;
+        hash  = rotateLeft64(hash, 23) * PRIME64_2 + PRIME64_3;
+        offset += 4;
+    }
+    for (; offset < size; offset++) {
+        hash ^= data[offset] * PRIME64_5;
+        hash  = rotateLeft64(hash, 11) * PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+static uint64_t xxh64(const void* data, NVectorSize size, uint64_t seed) {
+    const uint8_t* bytes = data;
+    uint64_t hash;
+    NVectorSize offset=0;
+    if (size >= 32) {
+        uint64_t accumulators[4];
+        xxh64InitializeAccumulators(accumulators, seed);
+        offset = xxh64ConsumeStripes(accumulators, bytes, size);
+        hash = xxh64MergeAccumulators(accumulators);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+    hash += size;
+    return xxh64Finish(hash, &bytes[offset], size - offset);
+}
+
+static uint64_t xxh64ByteVector(struct NByteVector* vector, uint64_t seed) {
+    return xxh64(vector->objects, vector->size, seed);
+}
+
+static uint64_t xxh64String(struct NString* string, uint64_t seed) {
+    return xxh64(string->string.objects, NString_length(string), seed);
+}
+
+static void xxh64Initialize(struct NHashXXH64State* state, uint64_t seed) {
+    NSystemUtils.memset(state, 0, sizeof(struct NHashXXH64State));
+    xxh64InitializeAccumulators(state->accumulators, seed);
+    state->seed = seed;
+}
+
+static void xxh64Update(struct NHashXXH64State* state, const void* data, NVectorSize size) {
+    const uint8_t* bytes = data;
+    state->totalSize += size;
+
+    // Complete a buffered stripe first,
+    if (state->bufferSize) {
+        NVectorSize copiedSize = 32 - state->bufferSize;
+        if (copiedSize > size) copiedSize = size;
+        NSystemUtils.memcpy(&state->buffer[state->bufferSize], bytes, copiedSize);
+        state->bufferSize += copiedSize;
+        bytes += copiedSize;
+        size -= copiedSize;
+        if (state->bufferSize < 32) return;
+        xxh64ConsumeStripes(state->accumulators, state->buffer, 32);
+        state->bufferSize = 0;
+    }
+
+    // Consume whole stripes directly, buffer the rest,
+    NVectorSize consumedSize = xxh64ConsumeStripes(state->accumulators, bytes, size);
+    state->bufferSize = size - consumedSize;
+    NSystemUtils.memcpy(state->buffer, &bytes[consumedSize], state->bufferSize);
+}
+
+static uint64_t xxh64Finalize(struct NHashXXH64State* state) {
+    uint64_t hash = (state->totalSize >= 32) ?
+            xxh64MergeAccumulators(state->accumulators) :
+            state->seed + PRIME64_5;
+    hash += state->totalSize;
+    return xxh64Finish(hash, state->buffer, state->bufferSize);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// CRC32C
+/////////////////////////////////////////////////////////////////////////////////////
+
+#define CRC32C_POLYNOMIAL 0x82F63B78 // Reversed.
+
+// Slicing-by-8 tables. Generated on first use,
+static uint32_t crc32cTables[8][256];
+static boolean crc32cTablesReady=False;
+
+static void generateCrc32cTables() {
+    for (uint32_t i=0; i<256; i++) {
+        uint32_t crc = i;
+        for (int32_t bit=0; bit<8; bit++) crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+        crc32cTables[0][i] = crc;
+    }
+    for (uint32_t i=0; i<256; i++) {
+        for (int32_t table=1; table<8; table++) {
+            uint32_t previous = crc32cTables[table-1][i];
+            crc32cTables[table][i] = (previous >> 8) ^ crc32cTables[0][previous & 0xff];
+        }
+    }
+    crc32cTablesReady = True;
+}
+
+static uint32_t crc32cUpdateTables(uint32_t crc, const uint8_t* data, NVectorSize size) {
+    if (!crc32cTablesReady) generateCrc32cTables();
+
+    NVectorSize offset=0;
+    for (; offset+8 <= size; offset+=8) {
+        uint32_t low  = read32(&data[offset  ]) ^ crc;
+        uint32_t high = read32(&data[offset+4]);
+        crc = crc32cTables[7][ low        & 0xff] ^ crc32cTables[6][(low  >>  8) & 0xff] ^
+              crc32cTables[5][(low >> 16) & 0xff] ^ crc32cTables[4][ low  >> 24        ] ^
+              crc32cTables[3][ high       & 0xff] ^ crc32cTables[2][(high >>  8) & 0xff] ^
+              crc32cTables[1][(high >> 16)& 0xff] ^ crc32cTables[0][ high >> 24        ];
+    }
+    for (; offset < size; offset++) crc = (crc >> 8) ^ crc32cTables[0][(crc ^ data[offset]) & 0xff];
+    return crc;
+}
+
+#if NHASH_X86_SIMD
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32cUpdateSSE42(uint32_t crc, const uint8_t* data, NVectorSize size) {
+    NVectorSize offset=0;
+    #if defined(__x86_64__)
+        uint64_t crc64 = crc;
+        for (; offset+8 <= size; offset+=8) {
+            uint64_t value;
+            NSTDLIB_INLINE_MEMCPY(&value, &data[offset], 8);
+            crc64 = _mm_crc32_u64(crc64, value);
+        }
+        crc = (uint32_t) crc64;
+    #endif
+    for (; offset+4 <= size; offset+=4) {
+        uint32_t value;
+        NSTDLIB_INLINE_MEMCPY(&value, &data[offset], 4);
+        crc = _mm_crc32_u32(crc, value);
+    }
+    for (; offset < size; offset++) crc = _mm_crc32_u8(crc, data[offset]);
+    return crc;
+}
+
+#endif
+
+// 0: tables, 1: SSE4.2. Detected once at runtime,
+static int32_t crc32cImplementation=-1;
+
+static uint32_t crc32cUpdate(uint32_t crc, const void* data, NVectorSize size) {
+    if (crc32cImplementation < 0) {
+        #if NHASH_X86_SIMD
+            __builtin_cpu_init();
+            crc32cImplementation = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+        #else
+            crc32cImplementation = 0;
+        #endif
+    }
+
+    // The crc is kept inverted while processing,
+    crc = ~crc;
+    #if NHASH_X86_SIMD
+    if (crc32cImplementation) return ~crc32cUpdateSSE42(crc, data, size);
+    #endif
+    return ~crc32cUpdateTables(crc, data, size);
+}
+
+static uint32_t crc32c(const void* data, NVectorSize size) {
+    return crc32cUpdate(0, data, size);
+}
+
+static uint32_t crc32cByteVector(struct NByteVector* vector) {
+    return crc32cUpdate(0, vector->objects, vector->size);
+}
+
+static uint32_t crc32cString(struct NString* string) {
+    return crc32cUpdate(0, string->string.objects, NString_length(string));
+}
+
+const struct NHash_Interface NHash = {
+    .xxh64 = xxh64,
+    .xxh64ByteVector = xxh64ByteVector,
+    .xxh64String = xxh64String,
+    .xxh64Initialize = xxh64Initialize,
+    .xxh64Update = xxh64Update,
+    .xxh64Finalize = xxh64Finalize,
+    .crc32c = crc32c,
+    .crc32cByteVector = crc32cByteVector,
+    .crc32cString = crc32cString,
+    .crc32cUpdate = crc32cUpdate
+};
@@ -0,0 +1,399 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NLZ.h>
+#include <NVarint.h>
+#include <NSystemUtils.h>
+#include <NError.h>
+
+// See: https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+
+#define MIN_MATCH_LENGTH 4
+#define LAST_LITERALS_LENGTH 5   // The last 5 bytes are always literals.
+#define MATCH_FIND_LIMIT 12      // The last match starts at least 12 bytes before the end.
+#define MAX_OFFSET 65535
+#define HASH_BITS 12             // 16KB hash table, fits in L1.
+#define SKIP_TRIGGER 6           // Speeds up skipping over incompressible data.
+#define FRAME_MAGIC "NLZF"
+
+static inline uint32_t read32(const uint8_t* data) {
+    uint32_t value;
+    NSTDLIB_INLINE_MEMCPY(&value, data, 4);
+    return value;
+}
+
+static inline uint64_t read64(const uint8_t* data) {
+    uint64_t value;
+    NSTDLIB_INLINE_MEMCPY(&value, data, 8);
+    return value;
+}
+
+static inline uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+// Copies in 16 bytes chunks. May write up to 15 bytes past dest+size,
+static inline void wildCopy16(uint8_t* dest, const uint8_t* source, NVectorSize size) {
+    uint8_t* destEnd = dest + size;
+    do {
+        NSTDLIB_INLINE_MEMCPY(dest, source, 16);
+        dest += 16;
+        source += 16;
+    } while (dest < destEnd);
+}
+
+// Returns the end of the written value,
+static inline uint8_t* writeVarint(uint8_t* output, uint64_t value) {
+    while (value >= 0x80) {
+        *output++ = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    *output++ = (uint8_t) value;
+    return output;
+}
+
+static NVectorSize compressBound(NVectorSize size) {
+    return NVARINT_MAX_SIZE + size + (size / 255) + 16;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Compression
+/////////////////////////////////////////////////////////////////////////////////////
+
+static inline uint8_t* writeLength(uint8_t* output, NVectorSize length) {
+    while (length >= 255) {
+        *output++ = 255;
+        length -= 255;
+    }
+    *output++ = (uint8_t) length;
+    return output;
+}
+
+static inline uint8_t* writeSequence(uint8_t* output, const uint8_t* literals, NVectorSize literalsLength, uint32_t offset, NVectorSize matchLength) {
+
+    // Token,
+    uint8_t* token = output++;
+    *token = (literalsLength >= 15) ? (15 << 4) : (uint8_t) (literalsLength << 4);
+    if (literalsLength >= 15) output = writeLength(output, literalsLength - 15);
+
+    // Literals,
+    NSystemUtils.memcpy(output, literals, literalsLength);
+    output += literalsLength;
+
+    // Match (absent in the last sequence),
+    if (matchLength) {
+        *output++ = (uint8_t) offset;
+        *output++ = (uint8_t) (offset >> 8);
+        matchLength -= MIN_MATCH_LENGTH;
+        *token |= (matchLength >= 15) ? 15 : (uint8_t) matchLength;
+        if (matchLength >= 15) output = writeLength(output, matchLength - 15);
+    }
+
+    return output;
+}
+
+// Greedy parsing with a single entry hash table. Returns the end of the output,
+static uint8_t* compressSequences(const uint8_t* input, NVectorSize inputSize, uint8_t* output) {
+
+    NVectorSize anchor=0;
+    if (inputSize > MATCH_FIND_LIMIT) {
+        uint32_t hashTable[1 << HASH_BITS];
+        NSystemUtils.memset(hashTable, 0, sizeof(hashTable));
+
+        NVectorSize matchFindLimit = inputSize - MATCH_FIND_LIMIT;
+        NVectorSize matchLimit = inputSize - LAST_LITERALS_LENGTH;
+        NVectorSize position=1;
+        uint32_t searchesCount = 1 << SKIP_TRIGGER;
+        while (position < matchFindLimit) {
+
+            // Look for a match,
+            uint32_t sequence = read32(&input[position]);
+            uint32_t hash = hashSequence(sequence);
+            NVectorSize candidate = hashTable[hash];
+            hashTable[hash] = (uint32_t) position;
+            if ((position - candidate > MAX_OFFSET) || (read32(&input[candidate]) != sequence)) {
+                // The longer we go without matches, the larger the steps,
+                position += searchesCount++ >> SKIP_TRIGGER;
+                continue;
+            }
+            searchesCount = 1 << SKIP_TRIGGER;
+
+            // Extend backwards,
+            while ((position > anchor) && (candidate > 0) && (input[position-1] == input[candidate-1])) {
+                position--;
+                candidate--;
+            }
+
+            // Extend forward, 8 bytes at a time,
+            NVectorSize matchLength = MIN_MATCH_LENGTH;
+            while (position + matchLength + 8 <= matchLimit) {
+                uint64_t difference = read64(&input[position + matchLength]) ^ read64(&input[candidate + matchLength]);
+                if (difference) {
+                    #if NBYTEVECTOR_BIG_ENDIAN_HOST
+                        matchLength += __builtin_clzll(difference) >> 3;
+                    #else
+                        matchLength += __builtin_ctzll(difference) >> 3;
+                    #endif
+                    goto matchExtended;
+                }
+                matchLength += 8;
+            }
+            while ((position + matchLength < matchLimit) && (input[position + matchLength] == input[candidate + matchLength])) matchLength++;
+            matchExtended:
+
+            output = writeSequence(output, &input[anchor], position - anchor, (uint32_t) (position - candidate), matchLength);
+            position += matchLength;
+            anchor = position;
+
+            // Index a position inside the match, improves the ratio at little cost,
+            if (position - 2 < matchFindLimit) hashTable[hashSequence(read32(&input[position-2]))] = (uint32_t) (position-2);
+        }
+    }
+
+    // Last literals,
+    return writeSequence(output, &input[anchor], inputSize - anchor, 0, 0);
+}
+
+static boolean compress(const void* data, NVectorSize size, struct NByteVector* output) {
+
+    // Positions are kept in 32bit in the hash table,
+    uint64_t size64 = size;
+    if (size64 > 0xffffffffULL) {
+        NERROR("NLZ.compress()", "Block too large: %s%ld", NTCOLOR(HIGHLIGHT), (int64_t) size);
+        return False;
+    }
+
+    uint8_t* blockStart = NByteVector_reserveWritable(output, compressBound(size));
+    if (!blockStart) return False;
+
+    // Compress, then store as is instead if it didn't help,
+    uint8_t* payload = blockStart + NVarint_size(((uint64_t) size) << 1);
+    uint8_t* payloadEnd = compressSequences(data, size, payload);
+    boolean isStored = (NVectorSize) (payloadEnd - payload) >= size;
+    if (isStored) {
+        NSystemUtils.memcpy(payload, data, size);
+        payloadEnd = payload + size;
+    }
+
+    // Header. Same size either way,
+    writeVarint(blockStart, (((uint64_t) size) << 1) | isStored);
+
+    return NByteVector_commit(output, payloadEnd - blockStart);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Decompression
+/////////////////////////////////////////////////////////////////////////////////////
+
+static inline boolean readLength(const uint8_t** input, const uint8_t* inputEnd, NVectorSize* length) {
+    uint8_t currentByte;
+    do {
+        if (*input == inputEnd) return False;
+        currentByte = *(*input)++;
+        *length += currentByte;
+    } while (currentByte == 255);
+    return True;
+}
+
+// Returns False if the input is corrupt or doesn't exactly fill the output,
+static boolean decompressSequences(const uint8_t* input, NVectorSize inputSize, uint8_t* output, NVectorSize outputSize) {
+
+    const uint8_t* inputEnd = input + inputSize;
+    uint8_t* outputStart = output;
+    uint8_t* outputEnd = output + outputSize;
+    while (input < inputEnd) {
+        uint8_t token = *input++;
+        NVectorSize literalsLength = token >> 4;
+        NVectorSize offset, matchLength;
+
+        // Fast path for short sequences (the vast majority) far from the ends. Fixed size copies,
+        // no length bytes and no last sequence to worry about,
+        if ((literalsLength < 15) && (inputEnd - input >= 32) && (outputEnd - output >= 32)) {
+            NSTDLIB_INLINE_MEMCPY(output, input, 16);
+            output += literalsLength;
+            input += literalsLength;
+
+            offset = input[0] | (input[1] << 8);
+            input += 2;
+            matchLength = token & 15;
+            if ((matchLength < 15) && (offset >= 8) && (offset <= (NVectorSize) (output - outputStart))) {
+                const uint8_t* match = output - offset;
+                NSTDLIB_INLINE_MEMCPY(output, match, 8);
+                NSTDLIB_INLINE_MEMCPY(output + 8, match + 8, 8);
+                NSTDLIB_INLINE_MEMCPY(output + 16, match + 16, 2);
+                output += matchLength + MIN_MATCH_LENGTH;
+                continue;
+            }
+        } else {
+
+            // Literals,
+            if ((literalsLength == 15) && !readLength(&input, inputEnd, &literalsLength)) return False;
+            if ((literalsLength > (NVectorSize) (inputEnd - input)) || (literalsLength > (NVectorSize) (outputEnd - output))) return False;
+            if (((outputEnd - output) >= 16) && ((inputEnd - input) >= 16) &&
+                (literalsLength <= (NVectorSize) (outputEnd - output) - 16) && (literalsLength <= (NVectorSize) (inputEnd - input) - 16)) {
+                wildCopy16(output, input, literalsLength);
+            } else {
+                NSystemUtils.memcpy(output, input, literalsLength);
+            }
+            output += literalsLength;
+            input += literalsLength;
+
+            // The last sequence has no match,
+            if (input == inputEnd) break;
+
+            if (inputEnd - input < 2) return False;
+            offset = input[0] | (input[1] << 8);
+            input += 2;
+            matchLength = token & 15;
+        }
+
+        // Match,
+        if (!offset || (offset > (NVectorSize) (output - outputStart))) return False;
+        if ((matchLength == 15) && !readLength(&input, inputEnd, &matchLength)) return False;
+        matchLength += MIN_MATCH_LENGTH;
+        if (matchLength > (NVectorSize) (outputEnd - output)) return False;
+
+        // Matches can overlap their own output (repeating patterns). Copy in chunks no larger than
+        // the offset, so every chunk reads bytes that were already written,
+        const uint8_t* match = output - offset;
+        NVectorSize room = outputEnd - output;
+        if ((offset >= 16) && (room >= 16) && (matchLength <= room - 16)) {
+            wildCopy16(output, match, matchLength);
+        } else if ((offset >= 8) && (room >= 8) && (matchLength <= room - 8)) {
+            uint8_t* matchEnd = output + matchLength;
+            uint8_t* dest = output;
+            do {
+                NSTDLIB_INLINE_MEMCPY(dest, match, 8);
+                dest += 8;
+                match += 8;
+            } while (dest < matchEnd);
+        } else {
+            for (NVectorSize i=0; i<matchLength; i++) output[i] = match[i];
+        }
+        output += matchLength;
+    }
+
+    return output == outputEnd;
+}
+
+// The header is validated against the payload before reserving any output, so a corrupt header
+// can't cause a huge allocation,
+static boolean decompressBlock(const void* data, NVectorSize size, uint64_t maxUncompressedSize, struct NByteVector* output) {
+
+    // Header,
+    uint64_t header;
+    NVectorSize headerSize = NVarint.decode(data, size, &header);
+    if (!headerSize) goto corrupt;
+    uint64_t uncompressedSize = header >> 1;
+    boolean isStored = header & 1;
+    if (uncompressedSize > maxUncompressedSize) goto corrupt;
+
+    // Stored blocks hold the data as is. A compressed byte expands to at most 255 bytes (a match
+    // length extension byte),
+    const uint8_t* payload = ((const uint8_t*) data) + headerSize;
+    NVectorSize payloadSize = size - headerSize;
+    if (isStored) {
+        if (payloadSize != uncompressedSize) goto corrupt;
+    } else if (uncompressedSize > (uint64_t) payloadSize * 255) {
+        goto corrupt;
+    }
+
+    uint8_t* destination = NByteVector_reserveWritable(output, (NVectorSize) uncompressedSize);
+    if (!destination && uncompressedSize) return False;
+
+    if (isStored) {
+        NSystemUtils.memcpy(destination, payload, payloadSize);
+    } else if (!decompressSequences(payload, payloadSize, destination, (NVectorSize) uncompressedSize)) {
+        goto corrupt;
+    }
+    return NByteVector_commit(output, (NVectorSize) uncompressedSize);
+
+    corrupt:
+    NERROR("NLZ.decompress()", "Corrupt block");
+    return False;
+}
+
+static boolean decompress(const void* data, NVectorSize size, struct NByteVector* output) {
+    return decompressBlock(data, size, NVECTOR_MAX_ALLOCATION_SIZE, output);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Frames
+/////////////////////////////////////////////////////////////////////////////////////
+
+static boolean beginFrame(struct NByteVector* output) {
+    return NByteVector_pushBackBulk(output, FRAME_MAGIC, 4);
+}
+
+static boolean compressToFrame(const void* data, NVectorSize size, struct NByteVector* output) {
+    const uint8_t* input = data;
+    while (size) {
+        NVectorSize blockInputSize = (size < NLZ_FRAME_BLOCK_SIZE) ? size : NLZ_FRAME_BLOCK_SIZE;
+
+        // Compress after some room for the block size, then move the block if the room was more
+        // than needed,
+        NVectorSize blockSizeOffset = output->size;
+        if (!NByteVector_reserveWritable(output, NVARINT_MAX_SIZE)) return False;
+        output->size += NVARINT_MAX_SIZE;
+        if (!compress(input, blockInputSize, output)) {
+            output->size = blockSizeOffset;
+            return False;
+        }
+
+        NVectorSize blockSize = output->size - blockSizeOffset - NVARINT_MAX_SIZE;
+        uint8_t blockSizeBytes[NVARINT_MAX_SIZE];
+        NVectorSize blockSizeLength = writeVarint(blockSizeBytes, blockSize) - blockSizeBytes;
+
+        uint8_t* blockSizeStart = &output->objects[blockSizeOffset];
+        NSystemUtils.memmove(blockSizeStart + blockSizeLength, blockSizeStart + NVARINT_MAX_SIZE, blockSize);
+        NSystemUtils.memcpy(blockSizeStart, blockSizeBytes, blockSizeLength);
+        output->size = blockSizeOffset + blockSizeLength + blockSize;
+
+        input += blockInputSize;
+        size -= blockInputSize;
+    }
+    return True;
+}
+
+static boolean endFrame(struct NByteVector* output) {
+    return NByteVector_pushBack(output, 0);
+}
+
+static NVectorSize decompressFrame(const void* data, NVectorSize size, struct NByteVector* output) {
+    const uint8_t* input = data;
+    NVectorSize originalOutputSize = output->size;
+    if ((size < 4) || NSystemUtils.memcmp(input, FRAME_MAGIC, 4)) goto corrupt;
+
+    NVectorSize offset = 4;
+    while (True) {
+        uint64_t blockSize;
+        NVectorSize blockSizeLength = NVarint.decode(&input[offset], size - offset, &blockSize);
+        if (!blockSizeLength) goto corrupt;
+        offset += blockSizeLength;
+        if (!blockSize) return offset;
+        if (blockSize > size - offset) goto corrupt;
+
+        // Frames are written in blocks of up to NLZ_FRAME_BLOCK_SIZE bytes,
+        if (!decompressBlock(&input[offset], (NVectorSize) blockSize, NLZ_FRAME_BLOCK_SIZE, output)) {
+            output->size = originalOutputSize;
+            return 0;
+        }
+        offset += (NVectorSize) blockSize;
+    }
+
+    corrupt:
+    NERROR("NLZ.decompressFrame()", "Corrupt frame");
+    output->size = originalOutputSize;
+    return 0;
+}
+
+const struct NLZ_Interface NLZ = {
+    .compressBound = compressBound,
+    .compress = compress,
+    .decompress = decompress,
+    .beginFrame = beginFrame,
+    .compressToFrame = compressToFrame,
+    .endFrame = endFrame,
+    .decompressFrame = decompressFrame
+};
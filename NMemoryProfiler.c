@@ -12,6 +12,8 @@
 #include <NSystemUtils.h>
 #include <NCString.h>
 
+#include <stddef.h>
+
 #define EXPANSION_RATIO 0.75f   // Expansions takes place when the:
                                 //   (allocated blocks count) / (total space for allocations)
                                 // ratio is larger than this value.
@@ -26,12 +28,13 @@ static uint32_t lastAllocationIndex;
 struct AllocationData {
     char* id;
     void* pointer;
-    int32_t size;
+    int64_t size;
 };
 static struct NVector allocationDatas;
 
+// Padded to malloc()'s alignment, so that the blocks after it are as aligned as malloc()'s,
 struct AllocationBundledData {
-    uint32_t allocationIndex;
+    _Alignas(max_align_t) uint32_t allocationIndex;
 };
 
 void NMemoryProfiler_initialize() {
@@ -67,7 +70,7 @@ static uint32_t getUnusedAllocationDataIndex() {
     } while (True);
 }
 
-void* NMemoryProfiler_malloc(int32_t size, const char* id) {
+void* NMemoryProfiler_malloc(int64_t size, const char* id) {
 
     // Attempt allocating memory,
     void* pointer = NSystemUtils.malloc(size + (profilingEnabled ? sizeof(struct AllocationBundledData) : 0));
@@ -105,6 +108,37 @@ void* NMemoryProfiler_malloc(int32_t size, const char* id) {
     return allocationData->pointer;
 }
 
+void* NMemoryProfiler_realloc(void* address, int64_t size, const char* id) {
+
+    if (!address) return NMemoryProfiler_malloc(size, id);
+    if (!profilingEnabled) return NSystemUtils.realloc(address, size);
+
+    // Get the allocation data,
+    struct AllocationBundledData* bundledData = address - sizeof(struct AllocationBundledData);
+    struct AllocationData* allocationData = NVector.get(&allocationDatas, bundledData->allocationIndex);
+
+    // If not found,
+    if (!allocationData || (allocationData->pointer!=address)) {
+        NLOGE("NMemoryProfiler", "realloc failed, attempted reallocating an unallocated block. Id: %s%s%s", NTCOLOR(HIGHLIGHT), id, NTCOLOR(STREAM_DEFAULT));
+        return 0;
+    }
+
+    // Attempt reallocating (the bundled data moves along with the block),
+    void* pointer = NSystemUtils.realloc(bundledData, size + sizeof(struct AllocationBundledData));
+    if (!pointer) {
+        NLOGE("NMemoryProfiler", "realloc failed. Id: %s%s%s", NTCOLOR(HIGHLIGHT), id, NTCOLOR(STREAM_DEFAULT));
+        return 0;
+    }
+
+    // Update status,
+    currentlyUsedMemory += size - allocationData->size;
+    if (currentlyUsedMemory > maxUsedMemory) maxUsedMemory = currentlyUsedMemory;
+    allocationData->pointer = pointer + sizeof(struct AllocationBundledData);
+    allocationData->size = size;
+
+    return allocationData->pointer;
+}
+
 void NMemoryProfiler_free(void* address, const char* id) {
 
     if (!profilingEnabled) {
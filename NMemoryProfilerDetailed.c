@@ -15,6 +15,8 @@
 #include <NSystemUtils.h>
 #include <NCString.h>
 
+#include <stddef.h>
+
 static boolean profilingEnabled=True;
 static int64_t currentlyUsedMemory=0;
 static int64_t maxUsedMemory=0;
@@ -26,9 +28,10 @@ struct AllocationData {
 };
 static struct NVector allocationDatas;
 
+// Padded to malloc()'s alignment, so that the blocks after it are as aligned as malloc()'s,
 struct AllocationBundledData {
-    struct AllocationData* allocationData;
-    uint32_t size;
+    _Alignas(max_align_t) struct AllocationData* allocationData;
+    uint64_t size;
 };
 
 void NMemoryProfiler_initialize() {
@@ -37,34 +40,34 @@ void NMemoryProfiler_initialize() {
     profilingEnabled = True;
 }
 
+static int32_t compareAllocationDataIds(const void* allocationData1, const void* allocationData2) {
+    return NCString.compare((*((struct AllocationData**) allocationData1))->id, (*((struct AllocationData**) allocationData2))->id);
+}
+
 static struct AllocationData* getAllocationData(const char* id) {
 
-    // TODO: use a binary search approach (based on id) later...
-    struct AllocationData* allocationData;
-    boolean found=False;
-    for (int32_t i=NVector.size(&allocationDatas)-1; i>=0; i--) {
-        allocationData = *((struct AllocationData**) NVector.get(&allocationDatas, i));
-        if (NCString.equals(allocationData->id, id)) {
-            found = True;
-            break;
-        }
+    // Allocation datas are kept sorted by id, so a binary search would do,
+    struct AllocationData keyAllocationData = { .id = (char*) id };
+    struct AllocationData* key = &keyAllocationData;
+    NVectorSize index = NVector.lowerBound(&allocationDatas, &key, compareAllocationDataIds);
+    if (index < NVector.size(&allocationDatas)) {
+        struct AllocationData* allocationData = *((struct AllocationData**) NVector.get(&allocationDatas, index));
+        if (NCString.equals(allocationData->id, id)) return allocationData;
     }
 
-    if (!found) {
-        // Create a new allocation data for this id,
-        allocationData = NSystemUtils.malloc(sizeof(struct AllocationData));
-        allocationData->id = NCString.clone(id);
-        allocationData->allocationsCount = 0;
-        allocationData->totalSize = 0;
-        allocationData->maxTotalSize = 0;
+    // Create a new allocation data for this id, and insert it in place,
+    struct AllocationData* allocationData = NSystemUtils.malloc(sizeof(struct AllocationData));
+    allocationData->id = NCString.clone(id);
+    allocationData->allocationsCount = 0;
+    allocationData->totalSize = 0;
+    allocationData->maxTotalSize = 0;
 
-        NVector.pushBack(&allocationDatas, &allocationData);
-    }
+    NVector.insertRange(&allocationDatas, index, &allocationData, 1);
 
     return allocationData;
 }
 
-void* NMemoryProfiler_malloc(int32_t size, const char* id) {
+void* NMemoryProfiler_malloc(int64_t size, const char* id) {
 
     // Attempt allocating memory,
     void* pointer = NSystemUtils.malloc(size + (profilingEnabled ? sizeof(struct AllocationBundledData) : 0));
@@ -100,6 +103,34 @@ void* NMemoryProfiler_malloc(int32_t size, const char* id) {
     return pointer + sizeof(struct AllocationBundledData);
 }
 
+void* NMemoryProfiler_realloc(void* address, int64_t size, const char* id) {
+
+    if (!address) return NMemoryProfiler_malloc(size, id);
+    if (!profilingEnabled) return NSystemUtils.realloc(address, size);
+
+    // Attempt reallocating (the bundled data moves along with the block),
+    struct AllocationBundledData* bundledData = address - sizeof(struct AllocationBundledData);
+    uint64_t originalSize = bundledData->size;
+    bundledData = NSystemUtils.realloc(bundledData, size + sizeof(struct AllocationBundledData));
+    if (!bundledData) {
+        NLOGE("NMemoryProfilerDetailed", "realloc failed. Id: %s%s%s", NTCOLOR(HIGHLIGHT), id, NTCOLOR(STREAM_DEFAULT));
+        return 0;
+    }
+    bundledData->size = size;
+
+    // Update status,
+    struct AllocationData* allocationData = bundledData->allocationData;
+    allocationData->totalSize += size;
+    allocationData->totalSize -= originalSize;
+    if (allocationData->totalSize > allocationData->maxTotalSize) allocationData->maxTotalSize = allocationData->totalSize;
+
+    currentlyUsedMemory += size;
+    currentlyUsedMemory -= originalSize;
+    if (currentlyUsedMemory > maxUsedMemory) maxUsedMemory = currentlyUsedMemory;
+
+    return ((void*) bundledData) + sizeof(struct AllocationBundledData);
+}
+
 void NMemoryProfiler_free(void* address, const char* id) {
 
     if (!profilingEnabled) {
@@ -0,0 +1,361 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NPriorityQueue.h>
+#include <NSystemUtils.h>
+
+typedef int32_t (*Comparator)(const void* object1, const void* object2);
+
+// Objects without a comparator start with an int64_t key. Reading through memcpy allows for
+// unaligned objects,
+static inline int64_t readKey(const void* object) {
+    int64_t key;
+    NSTDLIB_INLINE_MEMCPY(&key, object, sizeof(int64_t));
+    return key;
+}
+
+static inline boolean isLess(const void* object1, const void* object2, Comparator comparator) {
+    if (!comparator) return readKey(object1) < readKey(object2);
+    return comparator(object1, object2) < 0;
+}
+
+static inline uint8_t* getObject(uint8_t* objects, NVectorSize index, uint32_t objectSize) {
+    return &objects[index * objectSize];
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Priority queue
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Sifting moves a hole rather than swapping objects, so that every step copies a single object.
+// They are inlined into callers that check for the comparator once, so the int64_t key path gets
+// compiled without any indirect calls,
+
+static inline void siftUp(uint8_t* objects, NVectorSize index, const void* object, uint32_t objectSize, Comparator comparator) {
+    while (index) {
+        NVectorSize parentIndex = (index-1) >> 1;
+        uint8_t* parent = getObject(objects, parentIndex, objectSize);
+        if (!isLess(object, parent, comparator)) break;
+        NSTDLIB_INLINE_MEMCPY(getObject(objects, index, objectSize), parent, objectSize);
+        index = parentIndex;
+    }
+    NSTDLIB_INLINE_MEMCPY(getObject(objects, index, objectSize), object, objectSize);
+}
+
+static inline void siftDown(uint8_t* objects, NVectorSize index, NVectorSize objectsCount, const void* object, uint32_t objectSize, Comparator comparator) {
+    while (True) {
+        NVectorSize childIndex = (index << 1) + 1;
+        if (childIndex >= objectsCount) break;
+        uint8_t* child = getObject(objects, childIndex, objectSize);
+        if (childIndex+1 < objectsCount) {
+            uint8_t* rightChild = child + objectSize;
+            if (isLess(rightChild, child, comparator)) { childIndex++; child = rightChild; }
+        }
+        if (!isLess(child, object, comparator)) break;
+        NSTDLIB_INLINE_MEMCPY(getObject(objects, index, objectSize), child, objectSize);
+        index = childIndex;
+    }
+    NSTDLIB_INLINE_MEMCPY(getObject(objects, index, objectSize), object, objectSize);
+}
+
+static struct NPriorityQueue* initialize(struct NPriorityQueue* outputQueue, NVectorSize initialCapacity, uint32_t objectSize, Comparator comparator) {
+    if (!comparator && (objectSize < sizeof(int64_t))) return 0;
+    if (!NVector.initialize(&outputQueue->heap, initialCapacity, objectSize)) return 0;
+    outputQueue->comparator = comparator;
+    return outputQueue;
+}
+
+static struct NPriorityQueue* create(NVectorSize initialCapacity, uint32_t objectSize, Comparator comparator) {
+    struct NPriorityQueue* newQueue = NMALLOC(sizeof(struct NPriorityQueue), "NPriorityQueue.create() newQueue");
+    if (!initialize(newQueue, initialCapacity, objectSize, comparator)) {
+        NFREE(newQueue, "NPriorityQueue.create() newQueue");
+        return 0;
+    }
+    return newQueue;
+}
+
+static struct NPriorityQueue* initializeFromVector(struct NPriorityQueue* outputQueue, struct NVector* vector, Comparator comparator) {
+    if (!comparator && (vector->objectSize < sizeof(int64_t))) return 0;
+
+    // The spare slot past the last object holds the object being sifted,
+    if (!NVector_emplaceBack(vector)) return 0;
+    vector->objectsCount--;
+
+    // Take over the storage, leaving the vector empty but with its growth policy,
+    int32_t growthPolicy = vector->growthPolicy;
+    outputQueue->heap = *vector;
+    outputQueue->comparator = comparator;
+    NVector.initialize(vector, 0, vector->objectSize);
+    vector->growthPolicy = growthPolicy;
+
+    // Heapify bottom-up (Floyd's method), O(n),
+    NVectorSize objectsCount = outputQueue->heap.objectsCount;
+    uint32_t objectSize = outputQueue->heap.objectSize;
+    uint8_t* objects = outputQueue->heap.objects;
+    uint8_t* object = getObject(objects, objectsCount, objectSize);
+    for (NVectorSize i=objectsCount >> 1; i--;) {
+        NSTDLIB_INLINE_MEMCPY(object, getObject(objects, i, objectSize), objectSize);
+        if (comparator) {
+            siftDown(objects, i, objectsCount, object, objectSize, comparator);
+        } else {
+            siftDown(objects, i, objectsCount, object, objectSize, 0);
+        }
+    }
+
+    return outputQueue;
+}
+
+static void destroy(struct NPriorityQueue* queue) {
+    NVector.destroy(&queue->heap);
+    queue->comparator = 0;
+}
+
+static void destroyAndFree(struct NPriorityQueue* queue) {
+    destroy(queue);
+    NFREE(queue, "NPriorityQueue.destroyAndFree() queue");
+}
+
+static struct NPriorityQueue* clear(struct NPriorityQueue* queue) {
+    NVector.clear(&queue->heap);
+    return queue;
+}
+
+static boolean push(struct NPriorityQueue* queue, const void* object) {
+
+    // Make way for the new object, then sift it up from the end,
+    if (!NVector_emplaceBack(&queue->heap)) return False;
+    NVectorSize index = queue->heap.objectsCount-1;
+    if (queue->comparator) {
+        siftUp(queue->heap.objects, index, object, queue->heap.objectSize, queue->comparator);
+    } else {
+        siftUp(queue->heap.objects, index, object, queue->heap.objectSize, 0);
+    }
+    return True;
+}
+
+static boolean pop(struct NPriorityQueue* queue, void* outputObject) {
+    if (!queue->heap.objectsCount) return False;
+
+    // Output the top, then sift the last object down from the top,
+    uint8_t* objects = queue->heap.objects;
+    uint32_t objectSize = queue->heap.objectSize;
+    NSTDLIB_INLINE_MEMCPY(outputObject, objects, objectSize);
+    NVectorSize objectsCount = --queue->heap.objectsCount;
+    if (!objectsCount) return True;
+
+    // The last object is now outside the heap, so its slot is never written while sifting,
+    uint8_t* lastObject = getObject(objects, objectsCount, objectSize);
+    if (queue->comparator) {
+        siftDown(objects, 0, objectsCount, lastObject, objectSize, queue->comparator);
+    } else {
+        siftDown(objects, 0, objectsCount, lastObject, objectSize, 0);
+    }
+    return True;
+}
+
+static void* peek(struct NPriorityQueue* queue) {
+    if (!queue->heap.objectsCount) return 0;
+    return queue->heap.objects;
+}
+
+static NVectorSize size(struct NPriorityQueue* queue) {
+    return queue->heap.objectsCount;
+}
+
+const struct NPriorityQueue_Interface NPriorityQueue = {
+    .initialize = initialize,
+    .create = create,
+    .initializeFromVector = initializeFromVector,
+    .destroy = destroy,
+    .destroyAndFree = destroyAndFree,
+    .clear = clear,
+    .push = push,
+    .pop = pop,
+    .peek = peek,
+    .size = size
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Indexed priority queue
+/////////////////////////////////////////////////////////////////////////////////////
+
+// The heap holds ids, objects stay in place and are compared through the ids,
+
+static inline NVectorSize* getHeap(struct NIndexedPriorityQueue* queue) {
+    return (NVectorSize*) queue->heap.objects;
+}
+
+static inline NVectorIndex* getPositions(struct NIndexedPriorityQueue* queue) {
+    return (NVectorIndex*) queue->positions.objects;
+}
+
+static inline boolean isIdLess(struct NIndexedPriorityQueue* queue, NVectorSize id1, NVectorSize id2) {
+    uint32_t objectSize = queue->objects.objectSize;
+    uint8_t* objects = queue->objects.objects;
+    return isLess(getObject(objects, id1, objectSize), getObject(objects, id2, objectSize), queue->comparator);
+}
+
+static inline void placeId(struct NIndexedPriorityQueue* queue, NVectorSize index, NVectorSize id) {
+    getHeap(queue)[index] = id;
+    getPositions(queue)[id] = index;
+}
+
+static void siftIdUp(struct NIndexedPriorityQueue* queue, NVectorSize index, NVectorSize id) {
+    NVectorSize* heap = getHeap(queue);
+    while (index) {
+        NVectorSize parentIndex = (index-1) >> 1;
+        if (!isIdLess(queue, id, heap[parentIndex])) break;
+        placeId(queue, index, heap[parentIndex]);
+        index = parentIndex;
+    }
+    placeId(queue, index, id);
+}
+
+static void siftIdDown(struct NIndexedPriorityQueue* queue, NVectorSize index, NVectorSize id) {
+    NVectorSize* heap = getHeap(queue);
+    NVectorSize idsCount = queue->heap.objectsCount;
+    while (True) {
+        NVectorSize childIndex = (index << 1) + 1;
+        if (childIndex >= idsCount) break;
+        if ((childIndex+1 < idsCount) && isIdLess(queue, heap[childIndex+1], heap[childIndex])) childIndex++;
+        if (!isIdLess(queue, heap[childIndex], id)) break;
+        placeId(queue, index, heap[childIndex]);
+        index = childIndex;
+    }
+    placeId(queue, index, id);
+}
+
+static void restoreOrder(struct NIndexedPriorityQueue* queue, NVectorSize index) {
+    NVectorSize id = getHeap(queue)[index];
+    if (index && isIdLess(queue, id, getHeap(queue)[(index-1) >> 1])) {
+        siftIdUp(queue, index, id);
+    } else {
+        siftIdDown(queue, index, id);
+    }
+}
+
+static struct NIndexedPriorityQueue* initializeIndexed(struct NIndexedPriorityQueue* outputQueue, NVectorSize initialCapacity, uint32_t objectSize, Comparator comparator) {
+    if (!comparator && (objectSize < sizeof(int64_t))) return 0;
+
+    NSystemUtils.memset(outputQueue, 0, sizeof(struct NIndexedPriorityQueue));
+    if (!NVector.initialize(&outputQueue->objects, initialCapacity, objectSize)) return 0;
+    NVector.initialize(&outputQueue->heap, initialCapacity, sizeof(NVectorSize));
+    NVector.initialize(&outputQueue->positions, initialCapacity, sizeof(NVectorIndex));
+    outputQueue->comparator = comparator;
+
+    return outputQueue;
+}
+
+static struct NIndexedPriorityQueue* createIndexed(NVectorSize initialCapacity, uint32_t objectSize, Comparator comparator) {
+    struct NIndexedPriorityQueue* newQueue = NMALLOC(sizeof(struct NIndexedPriorityQueue), "NIndexedPriorityQueue.create() newQueue");
+    if (!initializeIndexed(newQueue, initialCapacity, objectSize, comparator)) {
+        NFREE(newQueue, "NIndexedPriorityQueue.create() newQueue");
+        return 0;
+    }
+    return newQueue;
+}
+
+static void destroyIndexed(struct NIndexedPriorityQueue* queue) {
+    NVector.destroy(&queue->heap);
+    NVector.destroy(&queue->positions);
+    NVector.destroy(&queue->objects);
+    queue->comparator = 0;
+}
+
+static void destroyAndFreeIndexed(struct NIndexedPriorityQueue* queue) {
+    destroyIndexed(queue);
+    NFREE(queue, "NIndexedPriorityQueue.destroyAndFree() queue");
+}
+
+static struct NIndexedPriorityQueue* clearIndexed(struct NIndexedPriorityQueue* queue) {
+    NVectorIndex* positions = getPositions(queue);
+    for (NVectorSize i=0; i<queue->positions.objectsCount; i++) positions[i] = -1;
+    NVector.clear(&queue->heap);
+    return queue;
+}
+
+static boolean containsIndexed(struct NIndexedPriorityQueue* queue, NVectorSize id) {
+    return (id < queue->positions.objectsCount) && (getPositions(queue)[id] >= 0);
+}
+
+static boolean updateIndexed(struct NIndexedPriorityQueue* queue, NVectorSize id, const void* object) {
+    if (!containsIndexed(queue, id)) return False;
+
+    NSTDLIB_INLINE_MEMCPY(getObject(queue->objects.objects, id, queue->objects.objectSize), object, queue->objects.objectSize);
+    restoreOrder(queue, getPositions(queue)[id]);
+    return True;
+}
+
+static boolean pushIndexed(struct NIndexedPriorityQueue* queue, NVectorSize id, const void* object) {
+    if (containsIndexed(queue, id)) return updateIndexed(queue, id, object);
+
+    // Make room for the id,
+    if (id >= queue->positions.objectsCount) {
+        // Mark the new ids as not queued before anything else can fail,
+        NVectorSize oldIdsCount = queue->positions.objectsCount;
+        if (!NVector.resize(&queue->positions, id+1)) return False;
+        NVectorIndex* positions = getPositions(queue);
+        for (NVectorSize i=oldIdsCount; i<=id; i++) positions[i] = -1;
+    }
+    if ((id >= queue->objects.objectsCount) && !NVector.resize(&queue->objects, id+1)) return False;
+    if (!NVector_emplaceBack(&queue->heap)) return False;
+
+    NSTDLIB_INLINE_MEMCPY(getObject(queue->objects.objects, id, queue->objects.objectSize), object, queue->objects.objectSize);
+    siftIdUp(queue, queue->heap.objectsCount-1, id);
+    return True;
+}
+
+static boolean removeIndexed(struct NIndexedPriorityQueue* queue, NVectorSize id) {
+    if (!containsIndexed(queue, id)) return False;
+
+    // Fill the hole with the last id,
+    NVectorSize index = getPositions(queue)[id];
+    getPositions(queue)[id] = -1;
+    NVectorSize lastId = getHeap(queue)[--queue->heap.objectsCount];
+    if (index < queue->heap.objectsCount) {
+        placeId(queue, index, lastId);
+        restoreOrder(queue, index);
+    }
+    return True;
+}
+
+static boolean popIndexed(struct NIndexedPriorityQueue* queue, NVectorSize* outputId, void* outputObject) {
+    if (!queue->heap.objectsCount) return False;
+
+    NVectorSize id = getHeap(queue)[0];
+    if (outputId) *outputId = id;
+    if (outputObject) NSTDLIB_INLINE_MEMCPY(outputObject, getObject(queue->objects.objects, id, queue->objects.objectSize), queue->objects.objectSize);
+    return removeIndexed(queue, id);
+}
+
+static boolean peekIndexed(struct NIndexedPriorityQueue* queue, NVectorSize* outputId) {
+    if (!queue->heap.objectsCount) return False;
+    *outputId = getHeap(queue)[0];
+    return True;
+}
+
+static void* getIndexed(struct NIndexedPriorityQueue* queue, NVectorSize id) {
+    if (!containsIndexed(queue, id)) return 0;
+    return getObject(queue->objects.objects, id, queue->objects.objectSize);
+}
+
+static NVectorSize sizeIndexed(struct NIndexedPriorityQueue* queue) {
+    return queue->heap.objectsCount;
+}
+
+const struct NIndexedPriorityQueue_Interface NIndexedPriorityQueue = {
+    .initialize = initializeIndexed,
+    .create = createIndexed,
+    .destroy = destroyIndexed,
+    .destroyAndFree = destroyAndFreeIndexed,
+    .clear = clearIndexed,
+    .push = pushIndexed,
+    .update = updateIndexed,
+    .remove = removeIndexed,
+    .pop = popIndexed,
+    .peek = peekIndexed,
+    .contains = containsIndexed,
+    .get = getIndexed,
+    .size = sizeIndexed
+};
@@ -0,0 +1,286 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NSegmentedVector.h>
+#include <NSystemUtils.h>
+
+static inline NVectorSize chunkCapacity(struct NSegmentedVector* vector) {
+    return ((NVectorSize) 1) << vector->chunkShift;
+}
+
+static inline uint8_t* getChunk(struct NSegmentedVector* vector, NVectorSize chunkIndex) {
+    return ((uint8_t**) vector->chunks.objects)[chunkIndex];
+}
+
+// Same as get(), without the boundary check,
+static inline void* getObject(struct NSegmentedVector* vector, NVectorSize index) {
+    return &getChunk(vector, index >> vector->chunkShift)[(index & (chunkCapacity(vector)-1)) * vector->objectSize];
+}
+
+static struct NSegmentedVector* initialize(struct NSegmentedVector* outputVector, uint32_t objectsPerChunk, uint32_t objectSize) {
+
+    if (objectSize==0) return 0;
+
+    // Default to chunks of about NSEGMENTED_VECTOR_DEFAULT_CHUNK_SIZE bytes,
+    if (!objectsPerChunk) objectsPerChunk = NSEGMENTED_VECTOR_DEFAULT_CHUNK_SIZE / objectSize;
+
+    // Round up to a power of 2. In 64bit, so that neither the shift nor the chunk size overflow,
+    if (objectsPerChunk > 0x80000000U) return 0;
+    uint32_t chunkShift=0;
+    while ((((uint64_t) 1) << chunkShift) < objectsPerChunk) chunkShift++;
+    uint64_t chunkSizeBytes = (((uint64_t) 1) << chunkShift) * objectSize;
+    if (chunkSizeBytes > NVECTOR_MAX_ALLOCATION_SIZE) return 0;
+
+    NSystemUtils.memset(outputVector, 0, sizeof(struct NSegmentedVector));
+    outputVector->objectSize = objectSize;
+    outputVector->chunkShift = chunkShift;
+    if (!NVector.initialize(&outputVector->chunks, 0, sizeof(void*))) return 0;
+
+    return outputVector;
+}
+
+static struct NSegmentedVector* create(uint32_t objectsPerChunk, uint32_t objectSize) {
+
+    if (objectSize==0) return 0;
+
+    struct NSegmentedVector* newVector = NMALLOC(sizeof(struct NSegmentedVector), "NSegmentedVector.create() newVector");
+    if (!initialize(newVector, objectsPerChunk, objectSize)) {
+        NFREE(newVector, "NSegmentedVector.create() newVector");
+        return 0;
+    }
+    return newVector;
+}
+
+static void destroy(struct NSegmentedVector* vector) {
+    for (NVectorSize i=0; i<vector->chunks.objectsCount; i++) NFREE(getChunk(vector, i), "NSegmentedVector.destroy() chunk");
+    NVector.destroy(&vector->chunks);
+    NSystemUtils.memset(vector, 0, sizeof(struct NSegmentedVector));
+}
+
+static void destroyAndFree(struct NSegmentedVector* vector) {
+    destroy(vector);
+    NFREE(vector, "NSegmentedVector.destroyAndFree() vector");
+}
+
+static struct NSegmentedVector* clear(struct NSegmentedVector* vector) {
+    vector->objectsCount = 0;
+    return vector;
+}
+
+static NVectorSize capacity(struct NSegmentedVector* vector) {
+    return vector->chunks.objectsCount << vector->chunkShift;
+}
+
+static boolean ensureCapacity(struct NSegmentedVector* vector, NVectorSize additionalCapacity) {
+
+    // Maybe we needn't do anything,
+    NVectorSize requiredCapacity = vector->objectsCount + additionalCapacity;
+    if (requiredCapacity < additionalCapacity) return False; // Overflow.
+    if (requiredCapacity <= capacity(vector)) return True;
+
+    // Only the chunk table is reallocated, the objects stay where they are,
+    NVectorSize requiredChunksCount = (requiredCapacity >> vector->chunkShift) + ((requiredCapacity & (chunkCapacity(vector)-1)) ? 1 : 0);
+    if (!NVector.ensureCapacity(&vector->chunks, requiredChunksCount - vector->chunks.objectsCount)) return False;
+
+    int64_t chunkSizeBytes = chunkCapacity(vector) * (int64_t) vector->objectSize;
+    while (vector->chunks.objectsCount < requiredChunksCount) {
+        void* newChunk = NMALLOC(chunkSizeBytes, "NSegmentedVector.ensureCapacity() newChunk");
+        if (!newChunk) return False;
+        NVector_pushBack(&vector->chunks, &newChunk);
+    }
+
+    return True;
+}
+
+static void* emplaceBack(struct NSegmentedVector* vector) {
+    return NSegmentedVector_emplaceBack(vector);
+}
+
+static boolean pushBack(struct NSegmentedVector* vector, const void *object) {
+    void *newObjectPointer = NSegmentedVector_emplaceBack(vector);
+    if (!newObjectPointer) return False;
+    NSTDLIB_INLINE_MEMCPY(newObjectPointer, object, vector->objectSize);
+    return True;
+}
+
+static boolean pushBackBulk(struct NSegmentedVector* vector, const void *objects, NVectorSize objectsCount) {
+
+    // Reserve once,
+    if (!ensureCapacity(vector, objectsCount)) return False;
+
+    // Copy chunk by chunk,
+    const uint8_t* source = objects;
+    while (objectsCount) {
+        NVectorSize indexInChunk = vector->objectsCount & (chunkCapacity(vector)-1);
+        NVectorSize copiedCount = chunkCapacity(vector) - indexInChunk;
+        if (copiedCount > objectsCount) copiedCount = objectsCount;
+
+        uint8_t* chunk = getChunk(vector, vector->objectsCount >> vector->chunkShift);
+        NSystemUtils.memcpy(&chunk[indexInChunk * vector->objectSize], source, copiedCount * vector->objectSize);
+
+        source += copiedCount * vector->objectSize;
+        vector->objectsCount += copiedCount;
+        objectsCount -= copiedCount;
+    }
+
+    return True;
+}
+
+static boolean popBack(struct NSegmentedVector* vector, void *outputObject) {
+    if (vector->objectsCount==0) return False;
+
+    vector->objectsCount--;
+    NSTDLIB_INLINE_MEMCPY(outputObject, getObject(vector, vector->objectsCount), vector->objectSize);
+
+    return True;
+}
+
+static void* get(struct NSegmentedVector* vector, NVectorSize index) {
+    return NSegmentedVector_get(vector, index);
+}
+
+static void* getLast(struct NSegmentedVector* vector) {
+    if (!vector->objectsCount) return 0;
+    return NSegmentedVector_get(vector, vector->objectsCount-1);
+}
+
+static NVectorIndex getFirstInstanceIndex(struct NSegmentedVector* vector, const void* object) {
+
+    // Search every chunk as a flat vector,
+    NVectorSize remainingCount = vector->objectsCount;
+    for (NVectorSize chunkIndex=0; remainingCount; chunkIndex++) {
+        NVectorSize chunkObjectsCount = (remainingCount < chunkCapacity(vector)) ? remainingCount : chunkCapacity(vector);
+        struct NVector chunkView = {
+            .capacity = chunkObjectsCount,
+            .objectSize = vector->objectSize,
+            .objectsCount = chunkObjectsCount,
+            .objects = getChunk(vector, chunkIndex)
+        };
+        NVectorIndex index = NVector.getFirstInstanceIndex(&chunkView, object);
+        if (index >= 0) return (NVectorIndex) (chunkIndex << vector->chunkShift) + index;
+        remainingCount -= chunkObjectsCount;
+    }
+
+    return -1;
+}
+
+// Moves objects between (possibly overlapping) ranges, in spans that don't cross chunk boundaries,
+static void moveObjects(struct NSegmentedVector* vector, NVectorSize destinationIndex, NVectorSize sourceIndex, NVectorSize objectsCount) {
+    NVectorSize chunkMask = chunkCapacity(vector)-1;
+    if (destinationIndex < sourceIndex) {
+        while (objectsCount) {
+            NVectorSize spanCount = chunkCapacity(vector) - (destinationIndex & chunkMask);
+            NVectorSize sourceSpanCount = chunkCapacity(vector) - (sourceIndex & chunkMask);
+            if (spanCount > sourceSpanCount) spanCount = sourceSpanCount;
+            if (spanCount > objectsCount) spanCount = objectsCount;
+            NSystemUtils.memmove(getObject(vector, destinationIndex), getObject(vector, sourceIndex), spanCount * vector->objectSize);
+            destinationIndex += spanCount;
+            sourceIndex += spanCount;
+            objectsCount -= spanCount;
+        }
+    } else if (destinationIndex > sourceIndex) {
+        // Back to front, so that the source isn't overwritten before it's moved,
+        NVectorSize destinationEnd = destinationIndex + objectsCount;
+        NVectorSize sourceEnd = sourceIndex + objectsCount;
+        while (objectsCount) {
+            NVectorSize spanCount = ((destinationEnd-1) & chunkMask) + 1;
+            NVectorSize sourceSpanCount = ((sourceEnd-1) & chunkMask) + 1;
+            if (spanCount > sourceSpanCount) spanCount = sourceSpanCount;
+            if (spanCount > objectsCount) spanCount = objectsCount;
+            destinationEnd -= spanCount;
+            sourceEnd -= spanCount;
+            NSystemUtils.memmove(getObject(vector, destinationEnd), getObject(vector, sourceEnd), spanCount * vector->objectSize);
+            objectsCount -= spanCount;
+        }
+    }
+}
+
+static boolean insertRange(struct NSegmentedVector* vector, NVectorSize index, const void *objects, NVectorSize objectsCount) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if (index > vector->objectsCount) return False;
+    #endif
+
+    // Reserve once, then make way for the new objects,
+    if (!ensureCapacity(vector, objectsCount)) return False;
+    NVectorSize movedCount = vector->objectsCount - index;
+    vector->objectsCount += objectsCount;
+    moveObjects(vector, index + objectsCount, index, movedCount);
+
+    // Copy chunk by chunk,
+    const uint8_t* source = objects;
+    while (objectsCount) {
+        NVectorSize indexInChunk = index & (chunkCapacity(vector)-1);
+        NVectorSize copiedCount = chunkCapacity(vector) - indexInChunk;
+        if (copiedCount > objectsCount) copiedCount = objectsCount;
+        NSystemUtils.memcpy(getObject(vector, index), source, copiedCount * vector->objectSize);
+
+        source += copiedCount * vector->objectSize;
+        index += copiedCount;
+        objectsCount -= copiedCount;
+    }
+
+    return True;
+}
+
+static void remove(struct NSegmentedVector* vector, NVectorIndex index) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if ((index < 0) || ((NVectorSize) index >= vector->objectsCount)) return;
+    #endif
+
+    moveObjects(vector, index, index+1, vector->objectsCount - index - 1);
+    vector->objectsCount--;
+}
+
+static void removeRange(struct NSegmentedVector* vector, NVectorSize startIndex, NVectorSize objectsCount) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if ((startIndex > vector->objectsCount) || (objectsCount > vector->objectsCount - startIndex)) return;
+    #endif
+
+    moveObjects(vector, startIndex, startIndex + objectsCount, vector->objectsCount - startIndex - objectsCount);
+    vector->objectsCount -= objectsCount;
+}
+
+static void swapRemove(struct NSegmentedVector* vector, NVectorIndex index) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if ((index < 0) || ((NVectorSize) index >= vector->objectsCount)) return;
+    #endif
+
+    vector->objectsCount--;
+    if ((NVectorSize) index != vector->objectsCount) {
+        NSystemUtils.memcpy(getObject(vector, index), getObject(vector, vector->objectsCount), vector->objectSize);
+    }
+}
+
+static NVectorSize size(struct NSegmentedVector* vector) {
+    return NSegmentedVector_size(vector);
+}
+
+static boolean resize(struct NSegmentedVector* vector, NVectorSize newSize) {
+    if ((newSize > vector->objectsCount) && !ensureCapacity(vector, newSize - vector->objectsCount)) return False;
+    vector->objectsCount = newSize;
+    return True;
+}
+
+const struct NSegmentedVector_Interface NSegmentedVector = {
+    .initialize = initialize,
+    .create = create,
+    .destroy = destroy,
+    .destroyAndFree = destroyAndFree,
+    .clear = clear,
+    .capacity = capacity,
+    .ensureCapacity = ensureCapacity,
+    .emplaceBack = emplaceBack,
+    .pushBack = pushBack,
+    .pushBackBulk = pushBackBulk,
+    .popBack = popBack,
+    .get = get,
+    .getLast = getLast,
+    .getFirstInstanceIndex = getFirstInstanceIndex,
+    .insertRange = insertRange,
+    .remove = remove,
+    .removeRange = removeRange,
+    .swapRemove = swapRemove,
+    .size = size,
+    .resize = resize
+};
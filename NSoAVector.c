@@ -0,0 +1,180 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NSoAVector.h>
+#include <NSystemUtils.h>
+
+static inline struct NVector* getColumns(struct NSoAVector* vector) {
+    return (struct NVector*) vector->columns.objects;
+}
+
+// Keeps the columns' counts in sync, so that each of them is a valid NVector on its own,
+static inline void setObjectsCount(struct NSoAVector* vector, NVectorSize objectsCount) {
+    struct NVector* columns = getColumns(vector);
+    for (uint32_t i=0; i<vector->columns.objectsCount; i++) columns[i].objectsCount = objectsCount;
+    vector->objectsCount = objectsCount;
+}
+
+static void destroy(struct NSoAVector* vector) {
+    struct NVector* columns = getColumns(vector);
+    for (uint32_t i=0; i<vector->columns.objectsCount; i++) NVector.destroy(&columns[i]);
+    NVector.destroy(&vector->columns);
+    NSystemUtils.memset(vector, 0, sizeof(struct NSoAVector));
+}
+
+static struct NSoAVector* initialize(struct NSoAVector* outputVector, NVectorSize initialCapacity, uint32_t columnsCount, const uint32_t* columnObjectSizes) {
+
+    if (!columnsCount) return 0;
+
+    NSystemUtils.memset(outputVector, 0, sizeof(struct NSoAVector));
+    if (!NVector.initialize(&outputVector->columns, columnsCount, sizeof(struct NVector))) return 0;
+
+    for (uint32_t i=0; i<columnsCount; i++) {
+        struct NVector* column = NVector.emplaceBack(&outputVector->columns);
+        if (!NVector.initialize(column, initialCapacity, columnObjectSizes[i])) {
+            outputVector->columns.objectsCount--;
+            destroy(outputVector);
+            return 0;
+        }
+        if (columnObjectSizes[i] > outputVector->maxObjectSize) outputVector->maxObjectSize = columnObjectSizes[i];
+    }
+    outputVector->capacity = initialCapacity;
+
+    return outputVector;
+}
+
+static struct NSoAVector* create(NVectorSize initialCapacity, uint32_t columnsCount, const uint32_t* columnObjectSizes) {
+    struct NSoAVector* newVector = NMALLOC(sizeof(struct NSoAVector), "NSoAVector.create() newVector");
+    if (!initialize(newVector, initialCapacity, columnsCount, columnObjectSizes)) {
+        NFREE(newVector, "NSoAVector.create() newVector");
+        return 0;
+    }
+    return newVector;
+}
+
+static void destroyAndFree(struct NSoAVector* vector) {
+    destroy(vector);
+    NFREE(vector, "NSoAVector.destroyAndFree() vector");
+}
+
+static struct NSoAVector* clear(struct NSoAVector* vector) {
+    setObjectsCount(vector, 0);
+    return vector;
+}
+
+static struct NSoAVector* setGrowthPolicy(struct NSoAVector* vector, int32_t growthPolicy) {
+    vector->growthPolicy = growthPolicy;
+    return vector;
+}
+
+static boolean ensureCapacity(struct NSoAVector* vector, NVectorSize additionalCapacity) {
+
+    // Maybe we needn't do anything,
+    NVectorSize requiredCapacity = vector->objectsCount + additionalCapacity;
+    if (requiredCapacity < additionalCapacity) return False; // Overflow.
+    if (requiredCapacity <= vector->capacity) return True;
+
+    // Grow all columns to the same capacity, decided by the policy for the widest column,
+    NVectorSize newCapacity = NGrowthPolicy.getNewCapacity(vector->growthPolicy, vector->capacity, requiredCapacity, vector->maxObjectSize);
+    if (!newCapacity) return False;
+
+    struct NVector* columns = getColumns(vector);
+    for (uint32_t i=0; i<vector->columns.objectsCount; i++) {
+        // Columns that grew before a failure are left larger, which is harmless,
+        if (!NVector.grow(&columns[i], newCapacity)) return False;
+    }
+    vector->capacity = newCapacity;
+
+    return True;
+}
+
+static boolean emplaceBack(struct NSoAVector* vector, void** outputColumnPointers) {
+
+    // Expand the vector capacity if needed,
+    if ((vector->objectsCount == vector->capacity) && !ensureCapacity(vector, 1)) return False;
+
+    // Make way for a new entry in every column,
+    struct NVector* columns = getColumns(vector);
+    for (uint32_t i=0; i<vector->columns.objectsCount; i++) {
+        if (outputColumnPointers) outputColumnPointers[i] = (void *)(((intptr_t) columns[i].objects) + (vector->objectsCount * columns[i].objectSize));
+        columns[i].objectsCount++;
+    }
+    vector->objectsCount++;
+
+    return True;
+}
+
+static boolean popBack(struct NSoAVector* vector, void** outputFields) {
+    if (vector->objectsCount==0) return False;
+
+    struct NVector* columns = getColumns(vector);
+    for (uint32_t i=0; i<vector->columns.objectsCount; i++) {
+        if (outputFields && outputFields[i]) {
+            NVector_popBack(&columns[i], outputFields[i]);
+        } else {
+            columns[i].objectsCount--;
+        }
+    }
+    vector->objectsCount--;
+
+    return True;
+}
+
+static void swapRemove(struct NSoAVector* vector, NVectorIndex index) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if ((index < 0) || ((NVectorSize) index >= vector->objectsCount)) return;
+    #endif
+
+    struct NVector* columns = getColumns(vector);
+    for (uint32_t i=0; i<vector->columns.objectsCount; i++) NVector.swapRemove(&columns[i], index);
+    vector->objectsCount--;
+}
+
+static void* get(struct NSoAVector* vector, uint32_t columnIndex, NVectorSize index) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if (columnIndex >= vector->columns.objectsCount) return 0;
+    #endif
+
+    return NVector_get(&getColumns(vector)[columnIndex], index);
+}
+
+static void* getColumn(struct NSoAVector* vector, uint32_t columnIndex) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if (columnIndex >= vector->columns.objectsCount) return 0;
+    #endif
+
+    return NSoAVector_getColumn(vector, columnIndex);
+}
+
+static uint32_t columnsCount(struct NSoAVector* vector) {
+    return vector->columns.objectsCount;
+}
+
+static NVectorSize size(struct NSoAVector* vector) {
+    return NSoAVector_size(vector);
+}
+
+static boolean resize(struct NSoAVector* vector, NVectorSize newSize) {
+    if ((newSize > vector->objectsCount) && !ensureCapacity(vector, newSize - vector->objectsCount)) return False;
+    setObjectsCount(vector, newSize);
+    return True;
+}
+
+const struct NSoAVector_Interface NSoAVector = {
+    .initialize = initialize,
+    .create = create,
+    .destroy = destroy,
+    .destroyAndFree = destroyAndFree,
+    .clear = clear,
+    .setGrowthPolicy = setGrowthPolicy,
+    .ensureCapacity = ensureCapacity,
+    .emplaceBack = emplaceBack,
+    .popBack = popBack,
+    .swapRemove = swapRemove,
+    .get = get,
+    .getColumn = getColumn,
+    .columnsCount = columnsCount,
+    .size = size,
+    .resize = resize
+};
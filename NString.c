@@ -1,4 +1,8 @@
 
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
 #include <NString.h>
 #include <NCString.h>
 #include <NError.h>
@@ -6,16 +10,29 @@
 
 static struct NString* vAppend(struct NString* outString, const char* format, va_list vaList);
 
-static inline struct NString* vInitialize(struct NString* string, const char* format, va_list vaList) {
-    NByteVector.initialize(&string->string, 4);
-    NByteVector.pushBack(&string->string, 0);
+// Heap backed if buffer is 0,
+static inline struct NString* vInitialize(struct NString* string, char* buffer, NVectorSize bufferSize, const char* format, va_list vaList) {
+    if (buffer) {
+        NByteVector.initializeWithBuffer(&string->string, buffer, bufferSize);
+    } else {
+        NByteVector.initialize(&string->string, 4);
+    }
+    NByteVector_pushBack(&string->string, 0);
     return vAppend(string, format, vaList);
 }
 
 static struct NString* initialize(struct NString* string, const char* format, ...) {
     va_list vaList;
     va_start(vaList, format);
-    vInitialize(string, format, vaList);
+    vInitialize(string, 0, 0, format, vaList);
+    va_end(vaList);
+    return string;
+}
+
+static struct NString* initializeWithBuffer(struct NString* string, char* buffer, NVectorSize bufferSize, const char* format, ...) {
+    va_list vaList;
+    va_start(vaList, format);
+    vInitialize(string, buffer, bufferSize, format, vaList);
     va_end(vaList);
     return string;
 }
@@ -29,250 +46,1061 @@ static void destroyAndFree(struct NString* string) {
     NFREE(string, "NString.destroyAndFree() string");
 }
 
-static inline int32_t positiveIntegerToDigits(char* outDigits, uint32_t integer) {
-    int32_t digitsCount=0;
-    do {
-        outDigits[digitsCount++] = integer % 10;
-        integer /= 10;
-    } while (integer);
-    return digitsCount;
+// Digit pairs "00" to "99", to convert integers two digits at a time,
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t powersOf10[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL };
+
+static inline int32_t decimalDigitsCount(uint64_t value) {
+    // log10(2) ~= 1233/4096. Or-ing with 1 doesn't change the count (10^n is even), but keeps 0 at 1 digit,
+    value |= 1;
+    int32_t estimate = ((64 - __builtin_clzll(value)) * 1233) >> 12;
+    return estimate + 1 - (value < powersOf10[estimate]);
 }
 
-static inline int32_t positiveLongToDigits(char* outDigits, uint64_t longInteger) {
-    int32_t digitsCount=0;
-    do {
-        outDigits[digitsCount++] = longInteger % 10;
-        longInteger /= 10;
-    } while (longInteger);
+// Writes the decimal digits (up to 20) to output. Returns the digits count,
+static inline int32_t writeDecimal(char* output, uint64_t value) {
+    int32_t digitsCount = decimalDigitsCount(value);
+    char* end = output + digitsCount;
+    while (value >= 100) {
+        uint32_t pairIndex = (uint32_t) (value % 100) * 2;
+        value /= 100;
+        end -= 2;
+        end[0] = digitPairs[pairIndex];
+        end[1] = digitPairs[pairIndex+1];
+    }
+    if (value >= 10) {
+        end[-2] = digitPairs[value*2];
+        end[-1] = digitPairs[value*2+1];
+    } else {
+        end[-1] = (char) ('0' + value);
+    }
     return digitsCount;
 }
 
-/////////////////////////////////////////////////////////////////////////////////////
-// Floating point to string conversion
-/////////////////////////////////////////////////////////////////////////////////////
+// Appends the sign and digits in place,
+static inline boolean appendInteger(struct NByteVector* outVector, int64_t value) {
+    char* output = NByteVector_reserveWritable(outVector, 20);
+    if (!output) return False;
+    uint64_t magnitude = (uint64_t) value;
+    int32_t signLength = 0;
+    if (value < 0) {
+        *output = '-';
+        magnitude = 0 - magnitude;
+        signLength = 1;
+    }
+    return NByteVector_commit(outVector, signLength + writeDecimal(output + signLength, magnitude));
+}
 
-// Feel free to modify these 3 numbers:
-#define FLOAT_TO_STRING_MAX_INTEGER_DIGITS  19  // Up to 19.
-#define FLOAT_TO_STRING_MAX_FRACTION_DIGITS  7  // Up to 18.
-#define MIN_FLOAT_NORMALIZATION_EXPONENT     5  // MUST be less than MAX_FRACTION_DIGITS.
+// Length of the run of characters before the first terminator or stopChar. Reads whole aligned
+// words, 8 characters at a time. Aligned reads never cross page boundaries, so reading past the
+// terminator can't fault,
+#define SWAR_ONES  0x0101010101010101ULL
+#define SWAR_HIGHS 0x8080808080808080ULL
+#define SWAR_HAS_ZERO_BYTE(word) (((word) - SWAR_ONES) & ~(word) & SWAR_HIGHS)
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((no_sanitize_address))
+#endif
+static inline NVectorSize runLength(const char* string, char stopChar) {
+    const char* current = string;
+    for (; ((uintptr_t) current) & 7; current++) {
+        if (!*current || (*current == stopChar)) return current - string;
+    }
 
-struct FloatToStringConversionSettings {
-    int32_t  maxIntegerDigitsCount;    // Up to 19.
-    int32_t maxFractionDigitsCount;    // Up to 18. Not 19, since one digit will be used for rounding.
+    uint64_t stopPattern = SWAR_ONES * (uint8_t) stopChar;
+    while (True) {
+        uint64_t word;
+        NSTDLIB_INLINE_MEMCPY(&word, current, 8);
+        if (SWAR_HAS_ZERO_BYTE(word) | SWAR_HAS_ZERO_BYTE(word ^ stopPattern)) break;
+        current += 8;
+    }
+    while (*current && (*current != stopChar)) current++;
+    return current - string;
+}
 
-    // Precomputed Values provided to avoid having to compute them at runtime.
-    float lowerNormalizationThreshold; // 1e(X), where X must be <   maxFractionDigitsCount.
-    float upperNormalizationThreshold; // 1e(X), where X must be =    maxIntegerDigitsCount.
-    uint64_t fractionDigitsShift;      // 1e(X), where X must be = 1+maxFractionDigitsCount.
-};
+/////////////////////////////////////////////////////////////////////////////////////
+// Floating point to string conversion
+/////////////////////////////////////////////////////////////////////////////////////
 
-// Because the arguments to a macro aren't expanded if they appear along with a # or ## in the macro body,
-// see: https://stackoverflow.com/a/3221914/1942069
-// and: https://stackoverflow.com/q/53803996/1942069
-// To test your macros, you can use them in a simple program and use:
-// => gcc -C -E SimpleProgram.c
-// to see how they end up.
-#define POSITIVE_EXPONENT(exp)               1e##exp
-#define MACRO_EXPAND_POSITIVE(macro) POSITIVE_EXPONENT(macro)
-#define NEGATIVE_EXPONENT(exp)               1e-##exp
-#define MACRO_EXPAND_NEGATIVE(macro) NEGATIVE_EXPONENT(macro)
-
-#define MAX_NO_NORMALIZATION_VALUE MACRO_EXPAND_POSITIVE(FLOAT_TO_STRING_MAX_INTEGER_DIGITS)
-#define MIN_NO_NORMALIZATION_VALUE MACRO_EXPAND_NEGATIVE(MIN_FLOAT_NORMALIZATION_EXPONENT)
-#define FRACTION_SHIFT_VALUE MACRO_EXPAND_POSITIVE(FLOAT_TO_STRING_MAX_FRACTION_DIGITS)
-
-static const struct FloatToStringConversionSettings DEFAULT_DOUBLE_CONVERSION_SETTINGS = {
-    .maxIntegerDigitsCount = FLOAT_TO_STRING_MAX_INTEGER_DIGITS,
-    .maxFractionDigitsCount = FLOAT_TO_STRING_MAX_FRACTION_DIGITS,
-    .upperNormalizationThreshold = MAX_NO_NORMALIZATION_VALUE,
-    .lowerNormalizationThreshold = MIN_NO_NORMALIZATION_VALUE,
-    .fractionDigitsShift = 10*FRACTION_SHIFT_VALUE
-};
+// Sign bit set, including -0,
+static inline boolean isSignNegative(double value) {
+    uint64_t bits;
+    NSTDLIB_INLINE_MEMCPY(&bits, &value, 8);
+    return (bits >> 63) != 0;
+}
 
-// True if a special value,
-static inline boolean appendDoubleToByteVector_HandleSignAndSpecialValues(struct NByteVector *outVector, double* value) {
+// True if a special value. upperCase gives NAN and INF (%E, %G),
+static inline boolean appendDoubleToByteVector_HandleSignAndSpecialValues(struct NByteVector *outVector, double* value, boolean upperCase) {
 
     // Handle NaN (not a number),
     if (NSystemUtils.isNaN(*value)) {
 
         // Not handling the different types of NAN here. See: https://stackoverflow.com/questions/3596622/negative-nan-is-not-a-nan#comment3775326_3596622
-        NByteVector.pushBack(outVector, 'n');
-        NByteVector.pushBack(outVector, 'a');
-        NByteVector.pushBack(outVector, 'n');
+        NByteVector_pushBackBulk(outVector, upperCase ? "NAN" : "nan", 3);
         return True;
     }
 
     // Make positive,
-    if (*value<0) {
-        NByteVector.pushBack(outVector, '-');
+    if (isSignNegative(*value)) {
+        NByteVector_pushBack(outVector, '-');
         *value = 0 - *value;
     }
 
     // Handle infinity,
     if (NSystemUtils.isInf(*value)) {
-        NByteVector.pushBack(outVector, 'i');
-        NByteVector.pushBack(outVector, 'n');
-        NByteVector.pushBack(outVector, 'f');
+        NByteVector_pushBackBulk(outVector, upperCase ? "INF" : "inf", 3);
         return True;
     }
 
     return False;
 }
 
-static inline void appendFloatToByteVector_Normalize(float* in_out_Value, int32_t* outExponent, const struct FloatToStringConversionSettings* conversionSettings) {
-
-    // Normalize. Turn extremely large/small values into exponent format, like following:
-    //  => Assume value is 1234.000. Normalizing it would result in 1.234e3.
-    //  => Assume value is 0.001234. Normalizing it would result in 1.234e-3.
-    // Note that (1e3 = 1e1*1e2), (1e5 = 1e4*1e1) and (1e7= 1e4*1e2*1e1), like binary numbers.
-    // Also note, float limits are: 1.175494351e-38 to 3.402823466e38.
-    float value = *in_out_Value;
-    int32_t exponent=0;
-    if (value >= conversionSettings->upperNormalizationThreshold) {
-        if (value >= 1e32 ) { exponent +=32; value *= 1e-32; }
-        if (value >= 1e16 ) { exponent +=16; value *= 1e-16; }
-        if (value >= 1e8  ) { exponent += 8; value *= 1e-8 ; }
-        if (value >= 1e4  ) { exponent += 4; value *= 1e-4 ; }
-        if (value >= 1e2  ) { exponent += 2; value *= 1e-2 ; }
-        if (value >= 1e1  ) { exponent += 1; value *= 1e-1 ; }
-    } else if (value <= conversionSettings->lowerNormalizationThreshold) {
-        if (value <  1e-31) { exponent -=32; value *= 1e32 ; }
-        if (value <  1e-15) { exponent -=16; value *= 1e16 ; }
-        if (value <  1e-7 ) { exponent -= 8; value *= 1e8  ; }
-        if (value <  1e-3 ) { exponent -= 4; value *= 1e4  ; }
-        if (value <  1e-1 ) { exponent -= 2; value *= 1e2  ; }
-        if (value <  1    ) { exponent -= 1; value *= 1e1  ; }
-    }
-
-    *in_out_Value = value;
-    *outExponent = exponent;
+// Lays out digits (first digit at 10^exponent) with fractionDigitsCount digits after the point.
+// Missing digits are zeros,
+static boolean appendFixedLayout(struct NByteVector* outVector, const char* digits, int32_t digitsCount, int32_t exponent, int32_t fractionDigitsCount, boolean forcePoint) {
+    int32_t integerDigitsCount = (exponent >= 0) ? exponent+1 : 1;
+    char* output = NByteVector_reserveWritable(outVector, integerDigitsCount + 1 + fractionDigitsCount);
+    if (!output) return False;
+
+    // Digit i has weight 10^(exponent-i). Position p (integer part from the left, then fraction)
+    // maps to digit index p-(integerDigitsCount-1-exponent),
+    char* current = output;
+    int32_t digitIndex = exponent - (integerDigitsCount-1);
+    for (int32_t i=0; i<integerDigitsCount; i++, digitIndex++) {
+        *current++ = ((digitIndex >= 0) && (digitIndex < digitsCount)) ? digits[digitIndex] : '0';
+    }
+    if (fractionDigitsCount || forcePoint) {
+        *current++ = '.';
+        for (int32_t i=0; i<fractionDigitsCount; i++, digitIndex++) {
+            *current++ = ((digitIndex >= 0) && (digitIndex < digitsCount)) ? digits[digitIndex] : '0';
+        }
+    }
+    return NByteVector_commit(outVector, current - output);
 }
 
-static inline void appendDoubleToByteVector_Normalize(double* in_out_Value, int32_t* outExponent, const struct FloatToStringConversionSettings* conversionSettings) {
-
-    // Normalize. Turn extremely large/small values into exponent format, like following:
-    //  => Assume value is 1234.000. Normalizing it would result in 1.234e3.
-    //  => Assume value is 0.001234. Normalizing it would result in 1.234e-3.
-    // Note that (1e3 = 1e1*1e2), (1e5 = 1e4*1e1) and (1e7= 1e4*1e2*1e1), like binary numbers.
-    // Also note, double limits are: 2.2250738585072014e-308 to 1.7976931348623158e308.
-    double value = *in_out_Value;
-    int32_t exponent=0;
-    if (value >= conversionSettings->upperNormalizationThreshold) {
-        if (value >= 1e256 ) { exponent +=256; value *= 1e-256; }
-        if (value >= 1e128 ) { exponent +=128; value *= 1e-128; }
-        if (value >= 1e64  ) { exponent += 64; value *= 1e-64 ; }
-        if (value >= 1e32  ) { exponent += 32; value *= 1e-32 ; }
-        if (value >= 1e16  ) { exponent += 16; value *= 1e-16 ; }
-        if (value >= 1e8   ) { exponent +=  8; value *= 1e-8  ; }
-        if (value >= 1e4   ) { exponent +=  4; value *= 1e-4  ; }
-        if (value >= 1e2   ) { exponent +=  2; value *= 1e-2  ; }
-        if (value >= 1e1   ) { exponent +=  1; value *= 1e-1  ; }
-    } else if (value <= conversionSettings->lowerNormalizationThreshold) {
-        if (value <  1e-256) { exponent -=256; value *= 1e256 ; }
-        if (value <  1e-128) { exponent -=128; value *= 1e128 ; }
-        if (value <  1e-64 ) { exponent -= 64; value *= 1e64  ; }
-        if (value <  1e-31 ) { exponent -= 32; value *= 1e32  ; }
-        if (value <  1e-15 ) { exponent -= 16; value *= 1e16  ; }
-        if (value <  1e-7  ) { exponent -=  8; value *= 1e8   ; }
-        if (value <  1e-3  ) { exponent -=  4; value *= 1e4   ; }
-        if (value <  1e-1  ) { exponent -=  2; value *= 1e2   ; }
-        if (value <  1     ) { exponent -=  1; value *= 1e1   ; }
-    }
-
-    *in_out_Value = value;
-    *outExponent = exponent;
+// d.ddde+XX, with at least 2 exponent digits (printf style) or d.ddde-X (compact),
+static boolean appendExponentialLayout(struct NByteVector* outVector, const char* digits, int32_t digitsCount, int32_t exponent, int32_t fractionDigitsCount, boolean forcePoint, boolean upperCase, boolean compact) {
+    char* output = NByteVector_reserveWritable(outVector, fractionDigitsCount + 8);
+    if (!output) return False;
+
+    char* current = output;
+    *current++ = digits[0];
+    if (fractionDigitsCount || forcePoint) {
+        *current++ = '.';
+        for (int32_t i=1; i<=fractionDigitsCount; i++) *current++ = (i < digitsCount) ? digits[i] : '0';
+    }
+
+    *current++ = upperCase ? 'E' : 'e';
+    if (exponent < 0) {
+        *current++ = '-';
+    } else if (!compact) {
+        *current++ = '+';
+    }
+    uint32_t exponentMagnitude = (exponent < 0) ? -exponent : exponent;
+    if ((exponentMagnitude < 10) && !compact) *current++ = '0';
+    current += writeDecimal(current, exponentMagnitude);
+    return NByteVector_commit(outVector, current - output);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Shortest representation (%f without precision)
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Grisu2. See: Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with
+// Integers", PLDI 2010. Generates the digits of a value within the rounding interval of the
+// float/double, so that parsing them gives back the same value. The output is the shortest
+// possible for the vast majority of values (99.9%), and at most a digit longer otherwise.
+
+// The range of values written in fixed notation. Outside it, the exponent notation is used,
+#define SHORTEST_FIXED_MIN_EXPONENT -5
+#define SHORTEST_FIXED_MAX_EXPONENT 18
+
+// significand * 2^exponent,
+struct DiyFloat {
+    uint64_t significand;
+    int32_t exponent;
+};
+
+// Upper 64 bits of the product, rounded,
+static inline struct DiyFloat diyMultiply(struct DiyFloat a, struct DiyFloat b) {
+    uint64_t aLow = a.significand & 0xffffffff, aHigh = a.significand >> 32;
+    uint64_t bLow = b.significand & 0xffffffff, bHigh = b.significand >> 32;
+    uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+    uint64_t middle = (lowLow >> 32) + (lowHigh & 0xffffffff) + (highLow & 0xffffffff) + (1ULL << 31);
+    struct DiyFloat result = {
+        .significand = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32),
+        .exponent = a.exponent + b.exponent + 64 };
+    return result;
+}
+
+static inline struct DiyFloat diyNormalize(struct DiyFloat value) {
+    int32_t shift = __builtin_clzll(value.significand);
+    value.significand <<= shift;
+    value.exponent -= shift;
+    return value;
+}
+
+// Cached powers of ten: significand * 2^binaryExponent ~= 10^decimalExponent, for every 8th
+// decimal exponent from -300 to 324. Rounded to nearest, computed with exact rational arithmetic,
+struct CachedPower {
+    uint64_t significand;
+    int32_t binaryExponent;
+    int32_t decimalExponent;
+};
+
+#define CACHED_POWERS_MIN_DECIMAL_EXPONENT -300
+#define CACHED_POWERS_DECIMAL_EXPONENT_STEP   8
+
+static const struct CachedPower cachedPowers[79] = {
+    { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+    { 0xBE5691EF416BD60CULL, -1007, -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+    { 0xD3515C2831559A83ULL,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+    { 0xEA9C227723EE8BCBULL,  -901, -252 },
+    { 0xAECC49914078536DULL,  -874, -244 },
+    { 0x823C12795DB6CE57ULL,  -847, -236 },
+    { 0xC21094364DFB5637ULL,  -821, -228 },
+    { 0x9096EA6F3848984FULL,  -794, -220 },
+    { 0xD77485CB25823AC7ULL,  -768, -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+    { 0xEF340A98172AACE5ULL,  -715, -196 },
+    { 0xB23867FB2A35B28EULL,  -688, -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+    { 0x936B9FCEBB25C996ULL,  -608, -164 },
+    { 0xDBAC6C247D62A584ULL,  -582, -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+    { 0x87625F056C7C4A8BULL,  -475, -124 },
+    { 0xC9BCFF6034C13053ULL,  -449, -116 },
+    { 0x964E858C91BA2655ULL,  -422, -108 },
+    { 0xDFF9772470297EBDULL,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+    { 0xB94470938FA89BCFULL,  -316,  -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+    { 0xCDB02555653131B6ULL,  -263,  -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+    { 0xAA242499697392D3ULL,  -183,  -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+    { 0xBCE5086492111AEBULL,  -130,  -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+    { 0xD1B71758E219652CULL,   -77,   -4 },
+    { 0x9C40000000000000ULL,   -50,    4 },
+    { 0xE8D4A51000000000ULL,   -24,   12 },
+    { 0xAD78EBC5AC620000ULL,     3,   20 },
+    { 0x813F3978F8940984ULL,    30,   28 },
+    { 0xC097CE7BC90715B3ULL,    56,   36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+    { 0xD5D238A4ABE98068ULL,   109,   52 },
+    { 0x9F4F2726179A2245ULL,   136,   60 },
+    { 0xED63A231D4C4FB27ULL,   162,   68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+    { 0x83C7088E1AAB65DBULL,   216,   84 },
+    { 0xC45D1DF942711D9AULL,   242,   92 },
+    { 0x924D692CA61BE758ULL,   269,  100 },
+    { 0xDA01EE641A708DEAULL,   295,  108 },
+    { 0xA26DA3999AEF774AULL,   322,  116 },
+    { 0xF209787BB47D6B85ULL,   348,  124 },
+    { 0xB454E4A179DD1877ULL,   375,  132 },
+    { 0x865B86925B9BC5C2ULL,   402,  140 },
+    { 0xC83553C5C8965D3DULL,   428,  148 },
+    { 0x952AB45CFA97A0B3ULL,   455,  156 },
+    { 0xDE469FBD99A05FE3ULL,   481,  164 },
+    { 0xA59BC234DB398C25ULL,   508,  172 },
+    { 0xF6C69A72A3989F5CULL,   534,  180 },
+    { 0xB7DCBF5354E9BECEULL,   561,  188 },
+    { 0x88FCF317F22241E2ULL,   588,  196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+    { 0x98165AF37B2153DFULL,   641,  212 },
+    { 0xE2A0B5DC971F303AULL,   667,  220 },
+    { 0xA8D9D1535CE3B396ULL,   694,  228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+    { 0xBB764C4CA7A44410ULL,   747,  244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+    { 0xD01FEF10A657842CULL,   800,  260 },
+    { 0x9B10A4E5E9913129ULL,   827,  268 },
+    { 0xE7109BFBA19C0C9DULL,   853,  276 },
+    { 0xAC2820D9623BF429ULL,   880,  284 },
+    { 0x80444B5E7AA7CF85ULL,   907,  292 },
+    { 0xBF21E44003ACDD2DULL,   933,  300 },
+    { 0x8E679C2F5E44FF8FULL,   960,  308 },
+    { 0xD433179D9C8CB841ULL,   986,  316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+};
+
+// Scaled values must have their binary exponent in [alpha, gamma], so that the integer part fits
+// in 32 bits and the fraction in 60 bits,
+#define GRISU_ALPHA -60
+#define GRISU_GAMMA -32
+
+static inline struct CachedPower getCachedPower(int32_t binaryExponent) {
+    // The smallest 10^k that brings binaryExponent into [alpha, gamma] (log10(2) ~= 78913/2^18),
+    int32_t f = GRISU_ALPHA - binaryExponent - 1;
+    int32_t k = (f * 78913) / (1 << 18) + (f > 0);
+    int32_t index = (k - CACHED_POWERS_MIN_DECIMAL_EXPONENT + CACHED_POWERS_DECIMAL_EXPONENT_STEP - 1) / CACHED_POWERS_DECIMAL_EXPONENT_STEP;
+    return cachedPowers[index];
+}
+
+// Moves the last digit towards the value as long as it stays within the interval,
+static inline void grisu2Round(char* digits, int32_t digitsCount, uint64_t distance, uint64_t delta, uint64_t rest, uint64_t tenToK) {
+    while ((rest < distance) && (delta - rest >= tenToK) &&
+           ((rest + tenToK < distance) || (distance - rest > rest + tenToK - distance))) {
+        digits[digitsCount-1]--;
+        rest += tenToK;
+    }
+}
+
+// Writes the digits of significand * 2^binaryExponent (a positive value with the hidden bit
+// included). Returns the digits count, and sets outDecimalExponent so that the value is
+// digits * 10^outDecimalExponent,
+static int32_t grisu2(uint64_t significand, int32_t binaryExponent, boolean lowerBoundaryIsCloser, char* outDigits, int32_t* outDecimalExponent) {
+
+    // The rounding interval boundaries: halfway to the neighbours. The lower one is closer for
+    // powers of 2 (the exponent changes),
+    struct DiyFloat value = { significand, binaryExponent };
+    struct DiyFloat upperBoundary = { 2*significand + 1, binaryExponent - 1 };
+    struct DiyFloat lowerBoundary = lowerBoundaryIsCloser ?
+            (struct DiyFloat) { 4*significand - 1, binaryExponent - 2 } :
+            (struct DiyFloat) { 2*significand - 1, binaryExponent - 1 };
+    upperBoundary = diyNormalize(upperBoundary);
+    lowerBoundary.significand <<= lowerBoundary.exponent - upperBoundary.exponent;
+    lowerBoundary.exponent = upperBoundary.exponent;
+    value = diyNormalize(value);
+
+    // Scale by a power of 10. The interval is shrunk by 1 ulp on each side to absorb the errors,
+    struct CachedPower cachedPower = getCachedPower(upperBoundary.exponent);
+    struct DiyFloat power = { cachedPower.significand, cachedPower.binaryExponent };
+    struct DiyFloat scaledValue = diyMultiply(value, power);
+    struct DiyFloat scaledLower = diyMultiply(lowerBoundary, power);
+    struct DiyFloat scaledUpper = diyMultiply(upperBoundary, power);
+    scaledLower.significand++;
+    scaledUpper.significand--;
+    int32_t decimalExponent = -cachedPower.decimalExponent;
+
+    // Generate the digits of the upper boundary until within the interval,
+    uint64_t delta = scaledUpper.significand - scaledLower.significand;
+    uint64_t distance = scaledUpper.significand - scaledValue.significand;
+    int32_t shift = -scaledUpper.exponent;
+    uint64_t one = 1ULL << shift;
+    uint32_t integerPart = (uint32_t) (scaledUpper.significand >> shift);
+    uint64_t fractionPart = scaledUpper.significand & (one - 1);
+
+    // Integer part digits. Written at once (avoiding a division per digit), then the remainder
+    // after each digit is checked,
+    int32_t integerDigitsCount = writeDecimal(outDigits, integerPart);
+    int32_t digitsCount=0;
+    while (digitsCount < integerDigitsCount) {
+        int32_t remainingIntegerDigits = integerDigitsCount - digitsCount - 1;
+        uint32_t digitWeight = (uint32_t) powersOf10[remainingIntegerDigits];
+        integerPart -= (uint32_t) (outDigits[digitsCount++] - '0') * digitWeight;
+
+        uint64_t rest = (((uint64_t) integerPart) << shift) + fractionPart;
+        if (rest <= delta) {
+            *outDecimalExponent = decimalExponent + remainingIntegerDigits;
+            grisu2Round(outDigits, digitsCount, distance, delta, rest, ((uint64_t) digitWeight) << shift);
+            return digitsCount;
+        }
+    }
+
+    // Fraction digits,
+    int32_t fractionDigitsCount=0;
+    while (True) {
+        fractionPart *= 10;
+        outDigits[digitsCount++] = (char) ('0' + (fractionPart >> shift));
+        fractionPart &= one - 1;
+        fractionDigitsCount++;
+        delta *= 10;
+        distance *= 10;
+        if (fractionPart <= delta) break;
+    }
+    *outDecimalExponent = decimalExponent - fractionDigitsCount;
+    grisu2Round(outDigits, digitsCount, distance, delta, fractionPart, one);
+    return digitsCount;
+}
+
+// Fixed notation for moderate exponents, compact exponent notation otherwise,
+static inline boolean appendShortestLayout(struct NByteVector* outVector, const char* digits, int32_t digitsCount, int32_t decimalExponent) {
+    int32_t exponent = digitsCount + decimalExponent - 1;
+    if ((exponent >= SHORTEST_FIXED_MIN_EXPONENT) && (exponent <= SHORTEST_FIXED_MAX_EXPONENT)) {
+        return appendFixedLayout(outVector, digits, digitsCount, exponent, (decimalExponent < 0) ? -decimalExponent : 0, False);
+    }
+    return appendExponentialLayout(outVector, digits, digitsCount, exponent, digitsCount-1, False, False, True);
+}
+
+// False if failed,
+static boolean appendDoubleToByteVector(struct NByteVector *outVector, double value) {
+
+    // Handle sign, NaN and Inf,
+    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &value, False)) return True;
+    if (value == 0) return NByteVector_pushBack(outVector, '0');
+
+    // 52 fraction bits, 11 exponent bits (bias 1023),
+    uint64_t bits;
+    NSTDLIB_INLINE_MEMCPY(&bits, &value, 8);
+    int32_t exponentBits = (int32_t) (bits >> 52);
+    uint64_t fraction = bits & ((1ULL << 52) - 1);
+    uint64_t significand = exponentBits ? (fraction | (1ULL << 52)) : fraction;
+    int32_t binaryExponent = (exponentBits ? exponentBits : 1) - 1075;
+
+    char digits[20];
+    int32_t decimalExponent;
+    int32_t digitsCount = grisu2(significand, binaryExponent, !fraction && (exponentBits > 1), digits, &decimalExponent);
+    return appendShortestLayout(outVector, digits, digitsCount, decimalExponent);
+}
+
+// False if failed,
+static boolean appendFloatToByteVector(struct NByteVector *outVector, float value) {
+
+    // Handle sign, NaN and Inf,
+    double doubleValue = value;
+    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &doubleValue, False)) return True;
+    value = (float) doubleValue;
+    if (value == 0) return NByteVector_pushBack(outVector, '0');
+
+    // 23 fraction bits, 8 exponent bits (bias 127). The interval is the float's, so the digits are
+    // the shortest that read back as the same float,
+    uint32_t bits;
+    NSTDLIB_INLINE_MEMCPY(&bits, &value, 4);
+    int32_t exponentBits = (int32_t) (bits >> 23);
+    uint32_t fraction = bits & ((1U << 23) - 1);
+    uint64_t significand = exponentBits ? (fraction | (1U << 23)) : fraction;
+    int32_t binaryExponent = (exponentBits ? exponentBits : 1) - 150;
+
+    char digits[20];
+    int32_t decimalExponent;
+    int32_t digitsCount = grisu2(significand, binaryExponent, !fraction && (exponentBits > 1), digits, &decimalExponent);
+    return appendShortestLayout(outVector, digits, digitsCount, decimalExponent);
 }
 
-static inline void appendDoubleToByteVector_HandleTextFormatting(struct NByteVector *outVector, double value, int32_t exponent, const struct FloatToStringConversionSettings* conversionSettings) {
+/////////////////////////////////////////////////////////////////////////////////////
+// Exact rounding (%.Nf, %e, %g)
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Doubles are m * 2^e exactly, so they have finite decimal expansions (up to 767 significant
+// digits). These are generated exactly and rounded half to even, matching glibc's printf. Values
+// and precisions in common ranges fit in 128bit integers. The rest go through a small bignum.
 
-    // Extract the integer and fraction parts as is, whether they were normalized or not,
-    uint64_t integerPart = (uint64_t) value;
-    value -= integerPart;
-    uint64_t fractionPart = (uint64_t) (value * conversionSettings->fractionDigitsShift);
+#define MAX_EXACT_DIGITS 800
+
+// Multi-precision unsigned integer, 32bit limbs, least significant first. Large enough for
+// 2^1024 and 2^53 * 5^1074,
+#define BIGNUM_MAX_LIMBS 84
+struct Bignum {
+    uint32_t limbs[BIGNUM_MAX_LIMBS];
+    int32_t limbsCount;
+};
 
-    // Rounding,
-    int32_t lastFractionDigit = fractionPart%10;
-    if (lastFractionDigit > 4) {
-        fractionPart += 10 - lastFractionDigit;
-        if (fractionPart == conversionSettings->fractionDigitsShift) {
-            fractionPart = 0;
-            integerPart++;
+static inline void bignumMultiplySmall(struct Bignum* number, uint32_t factor) {
+    uint64_t carry=0;
+    for (int32_t i=0; i<number->limbsCount; i++) {
+        uint64_t product = (uint64_t) number->limbs[i] * factor + carry;
+        number->limbs[i] = (uint32_t) product;
+        carry = product >> 32;
+    }
+    if (carry) number->limbs[number->limbsCount++] = (uint32_t) carry;
+}
+
+static inline void bignumShiftLeft(struct Bignum* number, int32_t shift) {
+    int32_t limbsShift = shift >> 5;
+    int32_t bitsShift = shift & 31;
+    if (bitsShift) {
+        number->limbs[number->limbsCount] = 0;
+        for (int32_t i=number->limbsCount; i>0; i--) {
+            number->limbs[i] = (number->limbs[i] << bitsShift) | (number->limbs[i-1] >> (32 - bitsShift));
         }
+        number->limbs[0] <<= bitsShift;
+        if (number->limbs[number->limbsCount]) number->limbsCount++;
+    }
+    if (limbsShift) {
+        for (int32_t i=number->limbsCount-1; i>=0; i--) number->limbs[i+limbsShift] = number->limbs[i];
+        for (int32_t i=0; i<limbsShift; i++) number->limbs[i] = 0;
+        number->limbsCount += limbsShift;
+    }
+}
+
+// Divides in place, returns the remainder,
+static inline uint32_t bignumDivideSmall(struct Bignum* number, uint32_t divisor) {
+    uint64_t remainder=0;
+    for (int32_t i=number->limbsCount-1; i>=0; i--) {
+        uint64_t current = (remainder << 32) | number->limbs[i];
+        number->limbs[i] = (uint32_t) (current / divisor);
+        remainder = current % divisor;
+    }
+    while (number->limbsCount && !number->limbs[number->limbsCount-1]) number->limbsCount--;
+    return (uint32_t) remainder;
+}
+
+// Writes all the significant digits of significand * 2^binaryExponent. Returns the digits count,
+// and sets outExponent to the decimal exponent of the first digit,
+static int32_t generateAllDigits(uint64_t significand, int32_t binaryExponent, char* outDigits, int32_t* outExponent) {
+
+    // m * 2^e, or m * 5^-e * 10^e for negative exponents,
+    struct Bignum number;
+    number.limbs[0] = (uint32_t) significand;
+    number.limbs[1] = (uint32_t) (significand >> 32);
+    number.limbsCount = number.limbs[1] ? 2 : 1;
+    int32_t decimalShift=0;
+    if (binaryExponent >= 0) {
+        bignumShiftLeft(&number, binaryExponent);
     } else {
-        fractionPart -= lastFractionDigit;
+        int32_t fivesCount = -binaryExponent;
+        for (; fivesCount >= 13; fivesCount -= 13) bignumMultiplySmall(&number, 1220703125); // 5^13.
+        uint32_t remainingFactor=1;
+        while (fivesCount--) remainingFactor *= 5;
+        bignumMultiplySmall(&number, remainingFactor);
+        decimalShift = binaryExponent;
     }
 
-    // Convert the integer part to string,
-    {
-        char integerDigits[conversionSettings->maxIntegerDigitsCount];
-        int32_t digitsCount = positiveLongToDigits(integerDigits, integerPart);
-        while (digitsCount--) NByteVector.pushBack(outVector, integerDigits[digitsCount]+48);
-    }
-
-    // Convert the fraction part, whether normalized or not,
-    if (fractionPart) {
-        NByteVector.pushBack(outVector, '.');
-        int32_t digitsCount = 1+conversionSettings->maxFractionDigitsCount; // 1 extra digit is used for rounding.
-        char fractionDigits[digitsCount];
-        for (int i=digitsCount-1; i; i--) fractionDigits[i] = 0; // Index 0 needn't be set, it should be overwritten in all cases.
-        positiveLongToDigits(fractionDigits, fractionPart);
-
-        // Remove trailing zeroes and push characters,
-        int32_t removedZeroesCount=0;
-        while (!fractionDigits[removedZeroesCount]) removedZeroesCount++;
-        digitsCount -= removedZeroesCount;
-        while (digitsCount--) NByteVector.pushBack(outVector, fractionDigits[removedZeroesCount+digitsCount]+48);
-    }
-
-    // Finally, append the exponent,
-    if (exponent) {
-        NByteVector.pushBack(outVector, 'e');
-        if (exponent < 0) {
-            NByteVector.pushBack(outVector, '-');
-            exponent = 0 - exponent;
+    // Convert to decimal, 9 digits at a time from the end,
+    char reversedDigits[MAX_EXACT_DIGITS + 9];
+    int32_t digitsCount=0;
+    while (number.limbsCount) {
+        uint32_t chunk = bignumDivideSmall(&number, 1000000000);
+        for (int32_t i=0; i<9; i++) {
+            reversedDigits[digitsCount++] = (char) ('0' + chunk % 10);
+            chunk /= 10;
         }
-        char exponentDigits[3];
-        int32_t digitsCount=positiveLongToDigits(exponentDigits, exponent);
-        while (digitsCount--) NByteVector.pushBack(outVector, exponentDigits[digitsCount]+48);
     }
+    while ((digitsCount > 1) && (reversedDigits[digitsCount-1] == '0')) digitsCount--;
+    *outExponent = digitsCount - 1 + decimalShift;
+
+    // Without the trailing zeros,
+    int32_t firstNonZeroIndex=0;
+    while ((firstNonZeroIndex < digitsCount-1) && (reversedDigits[firstNonZeroIndex] == '0')) firstNonZeroIndex++;
+    digitsCount -= firstNonZeroIndex;
+    for (int32_t i=0; i<digitsCount; i++) outDigits[i] = reversedDigits[firstNonZeroIndex + digitsCount-1-i];
+    return digitsCount;
 }
 
-static void appendFloatToByteVector(struct NByteVector *outVector, float floatValue, const struct FloatToStringConversionSettings* conversionSettings) {
+#ifdef __SIZEOF_INT128__
+// Writes the digits of a 128bit integer. Returns the digits count,
+static inline int32_t write128BitDecimal(char* output, unsigned __int128 value) {
+    const uint64_t tenToThe19 = 10000000000000000000ULL;
+    uint64_t chunks[3];
+    int32_t chunksCount=0;
+    while (value >= tenToThe19) {
+        chunks[chunksCount++] = (uint64_t) (value % tenToThe19);
+        value /= tenToThe19;
+    }
+    int32_t digitsCount = writeDecimal(output, (uint64_t) value);
+    while (chunksCount--) {
+        // Zero padded to 19 digits,
+        int32_t chunkDigitsCount = decimalDigitsCount(chunks[chunksCount]);
+        for (int32_t i=chunkDigitsCount; i<19; i++) output[digitsCount++] = '0';
+        digitsCount += writeDecimal(&output[digitsCount], chunks[chunksCount]);
+    }
+    return digitsCount;
+}
+#endif
+
+// Writes the digits of a positive finite value, rounded (half to even) at 10^roundingPosition.
+// Returns the digits count, and sets outExponent to the decimal exponent of the first digit.
+// Trailing zeros may be omitted. A value that rounds to 0 gives "0", at any exponent,
+static int32_t generateRoundedDigits(double value, int32_t roundingPosition, char* outDigits, int32_t* outExponent) {
+
+    uint64_t bits;
+    NSTDLIB_INLINE_MEMCPY(&bits, &value, 8);
+    int32_t exponentBits = (int32_t) (bits >> 52);
+    uint64_t fraction = bits & ((1ULL << 52) - 1);
+    uint64_t significand = exponentBits ? (fraction | (1ULL << 52)) : fraction;
+    int32_t binaryExponent = (exponentBits ? exponentBits : 1) - 1075;
+    if (!significand) {
+        outDigits[0] = '0';
+        *outExponent = roundingPosition;
+        return 1;
+    }
 
-    // Following this algorithm: https://blog.benoitblanchon.fr/lightweight-float-to-string/
+    #ifdef __SIZEOF_INT128__
+    // Fast path, round(m * 2^e / 10^position) in 128bit,
+    {
+        int32_t significandBits = 64 - __builtin_clzll(significand);
+        int32_t leftShift  = (binaryExponent > 0) ?  binaryExponent : 0;
+        int32_t rightShift = (binaryExponent < 0) ? -binaryExponent : 0;
+        int32_t tensMultiplier = (roundingPosition < 0) ? -roundingPosition : 0;
+        int32_t tensDivisor    = (roundingPosition > 0) ?  roundingPosition : 0;
+
+        // 10^n takes less than 3.33*n bits,
+        if ((significandBits + leftShift + ((tensMultiplier * 3402) >> 10) + 1 <= 127) &&
+            (rightShift < 127) && (tensDivisor <= 38) && !(rightShift && tensDivisor)) {
+
+            unsigned __int128 numerator = ((unsigned __int128) significand) << leftShift;
+            for (int32_t i=0; i<tensMultiplier; i++) numerator *= 10;
+
+            unsigned __int128 quotient, remainder, half;
+            boolean isExactHalfOrMore;
+            if (tensDivisor) {
+                unsigned __int128 divisor = 1;
+                for (int32_t i=0; i<tensDivisor; i++) divisor *= 10;
+                quotient = numerator / divisor;
+                remainder = numerator - quotient * divisor;
+                half = divisor - remainder; // Compared against the remainder, avoids overflowing.
+                isExactHalfOrMore = remainder >= half;
+            } else {
+                quotient = numerator >> rightShift;
+                remainder = rightShift ? numerator & ((((unsigned __int128) 1) << rightShift) - 1) : 0;
+                half = rightShift ? ((unsigned __int128) 1) << (rightShift - 1) : 1;
+                isExactHalfOrMore = rightShift && (remainder >= half);
+            }
+            if (isExactHalfOrMore && ((remainder != half) || (quotient & 1))) quotient++;
 
-    // Handle sign, NaN and Inf,
-    double doubleValue = floatValue;
-    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &doubleValue)) return ;
-    floatValue = doubleValue;
+            int32_t digitsCount = write128BitDecimal(outDigits, quotient);
+            *outExponent = roundingPosition + digitsCount - 1;
+            return digitsCount;
+        }
+    }
+    #endif
 
-    // Normalize (if needed),
+    // Slow path, all the digits, then round,
     int32_t exponent;
-    appendFloatToByteVector_Normalize(&floatValue, &exponent, conversionSettings);
+    int32_t digitsCount = generateAllDigits(significand, binaryExponent, outDigits, &exponent);
+    int32_t keptDigitsCount = exponent - roundingPosition + 1;
+    if (keptDigitsCount >= digitsCount) {
+        *outExponent = exponent;
+        return digitsCount;
+    }
 
-    // Format and append,
-    appendDoubleToByteVector_HandleTextFormatting(outVector, floatValue, exponent, conversionSettings);
-}
+    // Round up if more than half, or exactly half and odd,
+    boolean roundsUp = False;
+    if (keptDigitsCount >= 0) {
+        char firstDroppedDigit = outDigits[keptDigitsCount];
+        if (firstDroppedDigit > '5') {
+            roundsUp = True;
+        } else if (firstDroppedDigit == '5') {
+            // Trailing zeros were trimmed, so any digit after the 5 makes it more than half,
+            roundsUp = (keptDigitsCount+1 < digitsCount) || (keptDigitsCount && ((outDigits[keptDigitsCount-1] - '0') & 1));
+        }
+    }
+    if (keptDigitsCount <= 0) {
+        outDigits[0] = roundsUp ? '1' : '0';
+        *outExponent = roundingPosition;
+        return 1;
+    }
 
-static void appendDoubleToByteVector(struct NByteVector *outVector, double doubleValue, const struct FloatToStringConversionSettings* conversionSettings) {
+    if (roundsUp) {
+        int32_t i = keptDigitsCount-1;
+        while ((i >= 0) && (outDigits[i] == '9')) outDigits[i--] = '0';
+        if (i < 0) {
+            // All nines, becomes 1 followed by zeros,
+            outDigits[0] = '1';
+            *outExponent = exponent + 1;
+            return 1;
+        }
+        outDigits[i]++;
+    }
+    *outExponent = exponent;
+    return keptDigitsCount;
+}
 
-    // Following this algorithm: https://blog.benoitblanchon.fr/lightweight-float-to-string/
+// Finds the exponent of the first significant digit when rounded to significantDigitsCount
+// digits, and generates them,
+static int32_t generateSignificantDigits(double value, int32_t significantDigitsCount, char* outDigits, int32_t* outExponent) {
+
+    // Estimate from the binary exponent, never above the actual exponent (log10(2) ~= 78913/2^18),
+    uint64_t bits;
+    NSTDLIB_INLINE_MEMCPY(&bits, &value, 8);
+    int32_t exponentBits = (int32_t) (bits >> 52);
+    uint64_t fraction = bits & ((1ULL << 52) - 1);
+    int32_t log2Value = exponentBits ? (exponentBits - 1023) : (-1074 + 63 - __builtin_clzll(fraction | 1));
+    int32_t exponent = (log2Value * 78913) >> 18;
+
+    // If the estimate was 1 too low (or rounding carried into a new digit), retry at the next
+    // position, which gives the same result if it was only a carry,
+    while (True) {
+        int32_t digitsCount = generateRoundedDigits(value, exponent - significantDigitsCount + 1, outDigits, outExponent);
+        if (*outExponent <= exponent) return digitsCount;
+        exponent = *outExponent;
+    }
+}
 
-    // Handle sign, NaN and Inf,
-    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &doubleValue)) return ;
+// %.Nf. The alternate form always has a decimal point,
+static boolean appendFixed(struct NByteVector* outVector, double value, int32_t precision, boolean alternate) {
+    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &value, False)) return True;
 
-    // Normalize (if needed),
+    char digits[MAX_EXACT_DIGITS];
     int32_t exponent;
-    appendDoubleToByteVector_Normalize(&doubleValue, &exponent, conversionSettings);
+    int32_t digitsCount = generateRoundedDigits(value, -precision, digits, &exponent);
+    return appendFixedLayout(outVector, digits, digitsCount, exponent, precision, alternate);
+}
+
+// %e. The alternate form always has a decimal point,
+static boolean appendExponential(struct NByteVector* outVector, double value, int32_t precision, boolean alternate, boolean upperCase) {
+    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &value, upperCase)) return True;
+
+    char digits[MAX_EXACT_DIGITS];
+    int32_t exponent=0, digitsCount=1;
+    if (value == 0) {
+        digits[0] = '0';
+    } else {
+        digitsCount = generateSignificantDigits(value, precision+1, digits, &exponent);
+    }
+    return appendExponentialLayout(outVector, digits, digitsCount, exponent, precision, alternate, upperCase, False);
+}
+
+// %g. Fixed or exponential depending on the exponent, without trailing zeros. The alternate form
+// keeps the trailing zeros and always has a decimal point,
+static boolean appendGeneral(struct NByteVector* outVector, double value, int32_t precision, boolean alternate, boolean upperCase) {
+    if (appendDoubleToByteVector_HandleSignAndSpecialValues(outVector, &value, upperCase)) return True;
+
+    if (!precision) precision = 1;
+    char digits[MAX_EXACT_DIGITS];
+    int32_t exponent=0, digitsCount=1;
+    if (value == 0) {
+        digits[0] = '0';
+    } else {
+        digitsCount = generateSignificantDigits(value, precision, digits, &exponent);
+    }
+
+    int32_t lastSignificantIndex = precision-1;
+    if (!alternate) {
+        lastSignificantIndex = digitsCount-1;
+        while ((lastSignificantIndex > 0) && (digits[lastSignificantIndex] == '0')) lastSignificantIndex--;
+    }
 
-    // Format and append,
-    appendDoubleToByteVector_HandleTextFormatting(outVector, doubleValue, exponent, conversionSettings);
+    if ((exponent >= -4) && (exponent < precision)) {
+        int32_t fractionDigitsCount = lastSignificantIndex - exponent;
+        return appendFixedLayout(outVector, digits, digitsCount, exponent, (fractionDigitsCount > 0) ? fractionDigitsCount : 0, alternate);
+    }
+    return appendExponentialLayout(outVector, digits, digitsCount, exponent, lastSignificantIndex, alternate, upperCase, False);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 // Generating text from format
 /////////////////////////////////////////////////////////////////////////////////////
 
+// Parsing a specifier and appending its argument are shared by vAppend() and compiled formats.
+//
+// Supported: %% %s %c %d %i %u %x %X %p %f %e %E %g %G, with the length modifiers l (64bit) and
+// z (size_t) on integers, the flags '-' (left align), '0' (zero padding), '+', ' ' and '#' (0x
+// prefix on hex, always a decimal point on %f %e %g, and trailing zeros kept on %g), a field
+// width and a precision (digits for floats, minimum digits for integers, maximum characters for
+// strings). Width and precision can be '*', read from the arguments,
+#define FORMAT_ARGUMENT_NONE     0
+#define FORMAT_ARGUMENT_PERCENT  1
+#define FORMAT_ARGUMENT_STRING   2
+#define FORMAT_ARGUMENT_CHAR     3
+#define FORMAT_ARGUMENT_INT32    4
+#define FORMAT_ARGUMENT_INT64    5
+#define FORMAT_ARGUMENT_UINT32   6
+#define FORMAT_ARGUMENT_UINT64   7
+#define FORMAT_ARGUMENT_HEX32    8
+#define FORMAT_ARGUMENT_HEX64    9
+#define FORMAT_ARGUMENT_POINTER 10
+#define FORMAT_ARGUMENT_DOUBLE  11
+#define FORMAT_ARGUMENT_EXPONENTIAL 12
+#define FORMAT_ARGUMENT_GENERAL 13
+
+#define FORMAT_FLAG_LEFT_ALIGN 1
+#define FORMAT_FLAG_ZERO_PAD   2
+#define FORMAT_FLAG_PLUS       4
+#define FORMAT_FLAG_SPACE      8
+#define FORMAT_FLAG_ALTERNATE 16
+#define FORMAT_FLAG_UPPER_CASE 32
+
+#define FORMAT_FROM_ARGUMENT -2 // '*' width or precision.
+#define FORMAT_UNSPECIFIED   -1
+
+#define FORMAT_DEFAULT_FLOAT_PRECISION 6
+
+struct FormatSpecifier {
+    uint8_t type;
+    uint8_t flags;
+    int32_t width;
+    int32_t precision;
+};
+
+// Parses the specifier after a '%'. Returns the position after it, 0 if invalid,
+static inline const char* parseSpecifier(const char* position, struct FormatSpecifier* outSpecifier, const char* format) {
+
+    const char* specifierStart = position;
+    outSpecifier->flags = 0;
+    outSpecifier->width = FORMAT_UNSPECIFIED;
+    outSpecifier->precision = FORMAT_UNSPECIFIED;
+
+    // Fast path for the plain specifiers,
+    switch (*position) {
+        case '%': outSpecifier->type = FORMAT_ARGUMENT_PERCENT; return position+1;
+        case 's': outSpecifier->type = FORMAT_ARGUMENT_STRING ; return position+1;
+        case 'c': outSpecifier->type = FORMAT_ARGUMENT_CHAR   ; return position+1;
+        case 'd': outSpecifier->type = FORMAT_ARGUMENT_INT32  ; return position+1;
+        case 'f': outSpecifier->type = FORMAT_ARGUMENT_DOUBLE ; return position+1;
+    }
+
+    // Flags,
+    while (True) {
+        switch (*position) {
+            case '-': outSpecifier->flags |= FORMAT_FLAG_LEFT_ALIGN; position++; continue;
+            case '0': outSpecifier->flags |= FORMAT_FLAG_ZERO_PAD  ; position++; continue;
+            case '+': outSpecifier->flags |= FORMAT_FLAG_PLUS      ; position++; continue;
+            case ' ': outSpecifier->flags |= FORMAT_FLAG_SPACE     ; position++; continue;
+            case '#': outSpecifier->flags |= FORMAT_FLAG_ALTERNATE ; position++; continue;
+        }
+        break;
+    }
+
+    // Width and precision,
+    if (*position == '*') {
+        outSpecifier->width = FORMAT_FROM_ARGUMENT;
+        position++;
+    } else if ((*position >= '0') && (*position <= '9')) {
+        outSpecifier->width = 0;
+        while ((*position >= '0') && (*position <= '9')) outSpecifier->width = outSpecifier->width*10 + (*position++ - '0');
+    }
+    if (*position == '.') {
+        position++;
+        if (*position == '*') {
+            outSpecifier->precision = FORMAT_FROM_ARGUMENT;
+            position++;
+        } else {
+            outSpecifier->precision = 0;
+            while ((*position >= '0') && (*position <= '9')) outSpecifier->precision = outSpecifier->precision*10 + (*position++ - '0');
+        }
+    }
+
+    // Length modifier. In this library, 'l' always means 64bit,
+    char lengthModifier = 0;
+    int32_t integerSize = 4;
+    if (*position == 'l') {
+        lengthModifier = 'l';
+        integerSize = 8;
+        position++;
+        if (*position == 'l') position++;
+    } else if (*position == 'z') {
+        lengthModifier = 'z';
+        integerSize = sizeof(uintptr_t); // Same as size_t on all the supported platforms.
+        position++;
+    }
+
+    // Conversion,
+    char conversion = *position++;
+    switch (conversion) {
+        case 'd': case 'i':
+            outSpecifier->type = (integerSize == 8) ? FORMAT_ARGUMENT_INT64 : FORMAT_ARGUMENT_INT32;
+            return position;
+        case 'u':
+            outSpecifier->type = (integerSize == 8) ? FORMAT_ARGUMENT_UINT64 : FORMAT_ARGUMENT_UINT32;
+            return position;
+        case 'X':
+            outSpecifier->flags |= FORMAT_FLAG_UPPER_CASE;
+            // Fall through.
+        case 'x':
+            outSpecifier->type = (integerSize == 8) ? FORMAT_ARGUMENT_HEX64 : FORMAT_ARGUMENT_HEX32;
+            return position;
+    }
+    if (lengthModifier == 'z') goto invalid;
+    switch (conversion) {
+        case 'f': outSpecifier->type = FORMAT_ARGUMENT_DOUBLE; return position; // %lf is the same as %f.
+        case 'E': outSpecifier->flags |= FORMAT_FLAG_UPPER_CASE; // Fall through.
+        case 'e': outSpecifier->type = FORMAT_ARGUMENT_EXPONENTIAL; return position;
+        case 'G': outSpecifier->flags |= FORMAT_FLAG_UPPER_CASE; // Fall through.
+        case 'g': outSpecifier->type = FORMAT_ARGUMENT_GENERAL; return position;
+    }
+    if (lengthModifier) goto invalid;
+    switch (conversion) {
+        case 's': outSpecifier->type = FORMAT_ARGUMENT_STRING ; return position;
+        case 'c': outSpecifier->type = FORMAT_ARGUMENT_CHAR   ; return position;
+        case 'p': outSpecifier->type = FORMAT_ARGUMENT_POINTER; return position;
+    }
+
+    invalid:
+    NERROR("NString.vAppend", "Unexpected sequence: \"%s%%%c%s\" in format string: %s%s", NTCOLOR(HIGHLIGHT), *specifierStart, NTCOLOR(STREAM_DEFAULT), NTCOLOR(HIGHLIGHT), format);
+    return 0;
+}
+
+// Pads what was appended since fieldStart up to width characters. Zero padding goes after the
+// sign and the "0x" prefix, and only applies to (hex) digits, not to inf and nan,
+static boolean padField(struct NByteVector* outVector, NVectorSize fieldStart, NVectorSize width, uint8_t flags) {
+    NVectorSize fieldLength = outVector->size - fieldStart;
+    if (width <= fieldLength) return True;
+    NVectorSize paddingLength = width - fieldLength;
+    if (!NByteVector_reserveWritable(outVector, paddingLength)) return False;
+
+    uint8_t* field = &outVector->objects[fieldStart];
+    if (flags & FORMAT_FLAG_LEFT_ALIGN) {
+        NSystemUtils.memset(&field[fieldLength], ' ', paddingLength);
+        return NByteVector_commit(outVector, paddingLength);
+    }
+
+    NVectorSize prefixLength=0;
+    uint8_t paddingChar = ' ';
+    if (flags & FORMAT_FLAG_ZERO_PAD) {
+        if ((prefixLength < fieldLength) && ((field[0] == '-') || (field[0] == '+') || (field[0] == ' '))) prefixLength++;
+        if ((prefixLength+1 < fieldLength) && (field[prefixLength] == '0') && ((field[prefixLength+1] | 0x20) == 'x')) prefixLength += 2;
+        uint8_t firstChar = (prefixLength < fieldLength) ? field[prefixLength] : 0;
+        if (((firstChar >= '0') && (firstChar <= '9')) || (((firstChar | 0x20) >= 'a') && ((firstChar | 0x20) <= 'f'))) {
+            paddingChar = '0';
+        } else {
+            prefixLength = 0;
+        }
+    }
+    NSystemUtils.memmove(&field[prefixLength + paddingLength], &field[prefixLength], fieldLength - prefixLength);
+    NSystemUtils.memset(&field[prefixLength], paddingChar, paddingLength);
+    return NByteVector_commit(outVector, paddingLength);
+}
+
+static inline boolean appendUnsigned(struct NByteVector* outVector, uint64_t value) {
+    char* output = NByteVector_reserveWritable(outVector, 20);
+    if (!output) return False;
+    return NByteVector_commit(outVector, writeDecimal(output, value));
+}
+
+static inline boolean appendHex(struct NByteVector* outVector, uint64_t value, uint8_t flags) {
+    char* output = NByteVector_reserveWritable(outVector, 18);
+    if (!output) return False;
+
+    const char* digits = (flags & FORMAT_FLAG_UPPER_CASE) ? "0123456789ABCDEF" : "0123456789abcdef";
+    int32_t prefixLength = 0;
+    if ((flags & FORMAT_FLAG_ALTERNATE) && value) {
+        output[0] = '0';
+        output[1] = (flags & FORMAT_FLAG_UPPER_CASE) ? 'X' : 'x';
+        prefixLength = 2;
+    }
+    int32_t digitsCount = (64 - __builtin_clzll(value | 1) + 3) >> 2;
+    for (int32_t i=prefixLength+digitsCount-1; i>=prefixLength; i--) {
+        output[i] = digits[value & 15];
+        value >>= 4;
+    }
+    return NByteVector_commit(outVector, prefixLength + digitsCount);
+}
+
+// Consumes the argument (if any) and appends it. False if failed,
+static inline boolean appendArgument(struct NByteVector* outVector, const struct FormatSpecifier* specifier, va_list* vaList) {
+
+    int32_t width = specifier->width;
+    int32_t precision = specifier->precision;
+    uint8_t flags = specifier->flags;
+    if (width == FORMAT_FROM_ARGUMENT) {
+        width = va_arg(*vaList, int);
+        if (width < 0) {
+            flags |= FORMAT_FLAG_LEFT_ALIGN;
+            width = -width;
+        }
+    }
+    if (precision == FORMAT_FROM_ARGUMENT) {
+        precision = va_arg(*vaList, int);
+        if (precision < 0) precision = FORMAT_UNSPECIFIED;
+    }
+
+    NVectorSize fieldStart = outVector->size;
+    boolean success = True;
+    switch (specifier->type) {
+        case FORMAT_ARGUMENT_PERCENT:
+            return NByteVector_pushBack(outVector, '%');
+        case FORMAT_ARGUMENT_STRING: {
+            const char* sourceString = va_arg(*vaList, const char*);
+            NVectorSize length;
+            if (precision < 0) {
+                length = runLength(sourceString, 0);
+            } else {
+                // Mustn't read beyond precision characters, the string might not be terminated,
+                for (length=0; ((int32_t) length < precision) && sourceString[length]; length++);
+            }
+            success = NByteVector_pushBackBulk(outVector, sourceString, length);
+            break;
+        }
+        case FORMAT_ARGUMENT_CHAR:
+            success = NByteVector_pushBack(outVector, (char) va_arg(*vaList, int)); // ‘char’ is promoted to ‘int’ when passed through ‘...’.
+            break;
+        case FORMAT_ARGUMENT_INT32:
+        case FORMAT_ARGUMENT_INT64: {
+            int64_t value = (specifier->type == FORMAT_ARGUMENT_INT32) ? (int64_t) va_arg(*vaList, int32_t) : va_arg(*vaList, int64_t);
+            if (value >= 0) {
+                if (flags & FORMAT_FLAG_PLUS) {
+                    success = NByteVector_pushBack(outVector, '+');
+                } else if (flags & FORMAT_FLAG_SPACE) {
+                    success = NByteVector_pushBack(outVector, ' ');
+                }
+            }
+            success = success && appendInteger(outVector, value);
+            break;
+        }
+        case FORMAT_ARGUMENT_UINT32:
+            success = appendUnsigned(outVector, va_arg(*vaList, uint32_t));
+            break;
+        case FORMAT_ARGUMENT_UINT64:
+            success = appendUnsigned(outVector, va_arg(*vaList, uint64_t));
+            break;
+        case FORMAT_ARGUMENT_HEX32:
+            success = appendHex(outVector, va_arg(*vaList, uint32_t), flags);
+            break;
+        case FORMAT_ARGUMENT_HEX64:
+            success = appendHex(outVector, va_arg(*vaList, uint64_t), flags);
+            break;
+        case FORMAT_ARGUMENT_POINTER:
+            success =
+                    NByteVector_pushBackBulk(outVector, "0x", 2) &&
+                    appendHex(outVector, (uintptr_t) va_arg(*vaList, void*), 0);
+            break;
+        case FORMAT_ARGUMENT_DOUBLE:
+        case FORMAT_ARGUMENT_EXPONENTIAL:
+        case FORMAT_ARGUMENT_GENERAL: {
+            double value = va_arg(*vaList, double);
+
+            // NaNs are printed unsigned, their sign goes here as in printf,
+            if (NSystemUtils.isNaN(value) && isSignNegative(value)) {
+                success = NByteVector_pushBack(outVector, '-');
+            } else if (!isSignNegative(value)) {
+                if (flags & FORMAT_FLAG_PLUS) {
+                    success = NByteVector_pushBack(outVector, '+');
+                } else if (flags & FORMAT_FLAG_SPACE) {
+                    success = NByteVector_pushBack(outVector, ' ');
+                }
+            }
+            boolean upperCase = (flags & FORMAT_FLAG_UPPER_CASE) ? True : False;
+            boolean alternate = (flags & FORMAT_FLAG_ALTERNATE) ? True : False;
+            if (specifier->type == FORMAT_ARGUMENT_DOUBLE) {
+                if (precision < 0) {
+                    // No precision, the default (shortest) representation,
+                    success = success && appendDoubleToByteVector(outVector, value);
+                } else {
+                    success = success && appendFixed(outVector, value, precision, alternate);
+                }
+            } else if (specifier->type == FORMAT_ARGUMENT_EXPONENTIAL) {
+                success = success && appendExponential(outVector, value, (precision < 0) ? FORMAT_DEFAULT_FLOAT_PRECISION : precision, alternate, upperCase);
+            } else {
+                success = success && appendGeneral(outVector, value, (precision < 0) ? FORMAT_DEFAULT_FLOAT_PRECISION : precision, alternate, upperCase);
+            }
+            break;
+        }
+    }
+    if (!success) return False;
+
+    // Integer precision is a minimum digits count,
+    if ((precision >= 0) && (specifier->type >= FORMAT_ARGUMENT_INT32) && (specifier->type <= FORMAT_ARGUMENT_HEX64)) {
+        NVectorSize fieldLength = outVector->size - fieldStart;
+        const uint8_t* field = &outVector->objects[fieldStart];
+        NVectorSize digitsStart = 0;
+        if ((digitsStart < fieldLength) && ((field[0] == '-') || (field[0] == '+') || (field[0] == ' '))) digitsStart++;
+        if ((digitsStart+1 < fieldLength) && (field[digitsStart] == '0') && ((field[digitsStart+1] | 0x20) == 'x')) digitsStart += 2;
+
+        // As in printf, a zero value with a zero precision has no digits,
+        if (!precision && (fieldLength == digitsStart+1) && (field[digitsStart] == '0')) outVector->size--;
+        if (!padField(outVector, fieldStart, digitsStart + precision, FORMAT_FLAG_ZERO_PAD)) return False;
+        flags &= ~FORMAT_FLAG_ZERO_PAD; // As in printf, the zero flag is ignored when a precision is given.
+    }
+
+    if (width > 0) return padField(outVector, fieldStart, width, flags);
+    return True;
+}
+
 static struct NString* vAppend(struct NString* outString, const char* format, va_list vaList) {
 
     if (!format) return outString;
@@ -280,100 +1108,224 @@ static struct NString* vAppend(struct NString* outString, const char* format, va
     // Pop the termination zero,
     struct NByteVector *outVector = &outString->string;
     char tempChar;
-    NByteVector.popBack(outVector, (uint8_t*) &tempChar);
+    NByteVector_popBack(outVector, (uint8_t*) &tempChar);
+
+    // Parse the format string. The arguments list is copied so it can be passed around by pointer,
+    va_list arguments;
+    va_copy(arguments, vaList);
+    const char* currentPosition = format;
+    while (True) {
+
+        // Regular characters, copied in runs,
+        NVectorSize literalsLength = runLength(currentPosition, '%');
+        if (literalsLength) {
+            NByteVector_pushBackBulk(outVector, currentPosition, literalsLength);
+            currentPosition += literalsLength;
+        }
+        if (!*currentPosition) break;
+
+        // Found a '%',
+        struct FormatSpecifier specifier;
+        currentPosition = parseSpecifier(currentPosition+1, &specifier, format);
+        if (!currentPosition || !appendArgument(outVector, &specifier, &arguments)) break;
+    }
+    va_end(arguments);
+
+    // Add the termination zero,
+    NByteVector_pushBack(outVector, 0);
 
-    // Parse the format string,
-    int32_t index=0;
-    char currentChar;
-    while ((currentChar = format[index++])) {
+    return outString;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Compiled formats
+/////////////////////////////////////////////////////////////////////////////////////
 
-        // Regular characters,
-        if (currentChar!='%') {
-            NByteVector.pushBack(outVector, currentChar);
+// A run of literal text followed by an argument (none for the trailing text),
+struct FormatSegment {
+    NVectorSize literalOffset;
+    NVectorSize literalLength;
+    struct FormatSpecifier argument;
+};
+
+// Room reserved per argument, on top of the literals, before appending,
+#define COMPILED_FORMAT_ARGUMENT_SIZE_ESTIMATE 16
+
+static void destroyFormat(struct NStringFormat* format) {
+    NVector.destroy(&format->segments);
+    NByteVector.destroy(&format->literals);
+}
+
+static struct NStringFormat* initializeFormat(struct NStringFormat* outputFormat, const char* format) {
+    NVector.initialize(&outputFormat->segments, 0, sizeof(struct FormatSegment));
+    NByteVector.initialize(&outputFormat->literals, 0);
+    outputFormat->argumentsCount = 0;
+    if (!format) return outputFormat;
+
+    // Literal runs are merged across "%%",
+    struct FormatSegment segment = { .literalOffset = 0, .literalLength = 0 };
+    const char* currentPosition = format;
+    while (True) {
+        NVectorSize literalsLength = runLength(currentPosition, '%');
+        NByteVector_pushBackBulk(&outputFormat->literals, currentPosition, literalsLength);
+        segment.literalLength += literalsLength;
+        currentPosition += literalsLength;
+        if (!*currentPosition) break;
+
+        currentPosition = parseSpecifier(currentPosition+1, &segment.argument, format);
+        if (!currentPosition) {
+            destroyFormat(outputFormat);
+            return 0;
+        }
+        if (segment.argument.type == FORMAT_ARGUMENT_PERCENT) {
+            NByteVector_pushBack(&outputFormat->literals, '%');
+            segment.literalLength++;
             continue;
         }
 
-        // Found a '%',
-        currentChar = format[index++];
-        switch(currentChar) {
-            case '%': {
-                NByteVector.pushBack(outVector, '%');
-                continue;
-            }
-            case 's': {
-                const char* sourceString = va_arg(vaList, const char*);
+        NVector_pushBack(&outputFormat->segments, &segment);
+        outputFormat->argumentsCount++;
+        segment.literalOffset = outputFormat->literals.size;
+        segment.literalLength = 0;
+    }
 
-                int32_t stringIndex = 0;
-                char currentChar;
-                while ((currentChar = sourceString[stringIndex++])) {
-                    NByteVector.pushBack(outVector, currentChar);
-                }
-                continue;
-            }
-            case 'c': {
-                char sourceChar = (char) va_arg(vaList, int); // ‘char’ is promoted to ‘int’ when passed through ‘...’.
-                NByteVector.pushBack(outVector, sourceChar);
-                continue;
-            }
-            case 'd': {
-                int32_t sourceInteger = (int32_t) va_arg(vaList, int32_t);
+    // Trailing text,
+    if (segment.literalLength) {
+        segment.argument.type = FORMAT_ARGUMENT_NONE;
+        NVector_pushBack(&outputFormat->segments, &segment);
+    }
 
-                if (sourceInteger < 0) {
-                    NByteVector.pushBack(outVector, '-');
-                    sourceInteger = 0-sourceInteger;
-                }
+    return outputFormat;
+}
 
-                char digits[10];
-                int32_t digitsCount = positiveIntegerToDigits(digits, sourceInteger);
+static struct NStringFormat* createFormat(const char* format) {
+    struct NStringFormat* newFormat = NMALLOC(sizeof(struct NStringFormat), "NStringFormat.create() newFormat");
+    if (!initializeFormat(newFormat, format)) {
+        NFREE(newFormat, "NStringFormat.create() newFormat");
+        return 0;
+    }
+    return newFormat;
+}
 
-                // Push digits in reverse order,
-                while (digitsCount--) NByteVector.pushBack(outVector, digits[digitsCount]+48);
+static void destroyAndFreeFormat(struct NStringFormat* format) {
+    destroyFormat(format);
+    NFREE(format, "NStringFormat.destroyAndFree() format");
+}
 
-                continue;
-            }
-            case 'l': {
+// Open addressing hash table, keyed by the format pointer,
+struct FormatCacheEntry {
+    const char* key;
+    struct NStringFormat* format;
+};
 
-                // Check if a 'd' follows,
-                currentChar = format[index++];
-                if (currentChar != 'd') {
-                    NERROR("NString.vAppend", "Expected \"%sd%s\" after \"%s%%l%s\" in format string: %s%s", NTCOLOR(HIGHLIGHT), NTCOLOR(STREAM_DEFAULT), NTCOLOR(HIGHLIGHT), NTCOLOR(STREAM_DEFAULT), NTCOLOR(HIGHLIGHT), format);
-                    goto exit;
-                }
+static struct FormatCacheEntry* formatCache;
+static NVectorSize formatCacheCapacity; // Power of 2.
+static NVectorSize formatCacheCount;
 
-                int64_t sourceLong = (int64_t) va_arg(vaList, int64_t);
+#define FORMAT_CACHE_INITIAL_CAPACITY 64
 
-                if (sourceLong < 0) {
-                    NByteVector.pushBack(outVector, '-');
-                    sourceLong = 0 - sourceLong;
-                }
+static inline NVectorSize formatCacheSlot(const char* key, NVectorSize capacity) {
+    return (NVectorSize) ((((uint64_t) (uintptr_t) key) * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
 
-                char digits[19];
-                int32_t digitsCount = positiveLongToDigits(digits, sourceLong);
+static boolean growFormatCache() {
+    NVectorSize newCapacity = formatCacheCapacity ? formatCacheCapacity * 2 : FORMAT_CACHE_INITIAL_CAPACITY;
+    struct FormatCacheEntry* newCache = NMALLOC(newCapacity * sizeof(struct FormatCacheEntry), "NStringFormat.getCached() formatCache");
+    if (!newCache) return False;
+    NSystemUtils.memset(newCache, 0, newCapacity * sizeof(struct FormatCacheEntry));
+
+    // Rehash,
+    for (NVectorSize i=0; i<formatCacheCapacity; i++) {
+        if (!formatCache[i].key) continue;
+        NVectorSize slot = formatCacheSlot(formatCache[i].key, newCapacity);
+        while (newCache[slot].key) slot = (slot + 1) & (newCapacity - 1);
+        newCache[slot] = formatCache[i];
+    }
 
-                // Push digits in reverse order,
-                while (digitsCount--) NByteVector.pushBack(outVector, digits[digitsCount]+48);
+    if (formatCache) NFREE(formatCache, "NStringFormat.getCached() formatCache");
+    formatCache = newCache;
+    formatCacheCapacity = newCapacity;
+    return True;
+}
 
-                continue;
-            }
-            case 'f': {
-                double sourceDouble = (double) va_arg(vaList, double);
-                appendDoubleToByteVector(outVector, sourceDouble, &DEFAULT_DOUBLE_CONVERSION_SETTINGS);
-                continue;
-            }
+static const struct NStringFormat* getCachedFormat(const char* format) {
+    if (!format) return 0;
 
-            default:
-                NERROR("NString.vAppend", "Unexpected sequence: \"%s%%%c%s\" in format string: %s%s", NTCOLOR(HIGHLIGHT), currentChar, NTCOLOR(STREAM_DEFAULT), NTCOLOR(HIGHLIGHT), format);
-                goto exit;
+    // Look up,
+    if (formatCacheCapacity) {
+        NVectorSize slot = formatCacheSlot(format, formatCacheCapacity);
+        while (formatCache[slot].key) {
+            if (formatCache[slot].key == format) return formatCache[slot].format;
+            slot = (slot + 1) & (formatCacheCapacity - 1);
         }
     }
 
+    // Compile and insert. Kept at most 3/4 full,
+    struct NStringFormat* compiledFormat = createFormat(format);
+    if (!compiledFormat) return 0;
+    if (((formatCacheCount + 1) * 4 > formatCacheCapacity * 3) && !growFormatCache()) {
+        destroyAndFreeFormat(compiledFormat);
+        return 0;
+    }
+    NVectorSize slot = formatCacheSlot(format, formatCacheCapacity);
+    while (formatCache[slot].key) slot = (slot + 1) & (formatCacheCapacity - 1);
+    formatCache[slot].key = format;
+    formatCache[slot].format = compiledFormat;
+    formatCacheCount++;
+
+    return compiledFormat;
+}
+
+static void clearFormatCache() {
+    if (!formatCache) return;
+    for (NVectorSize i=0; i<formatCacheCapacity; i++) {
+        if (formatCache[i].key) destroyAndFreeFormat(formatCache[i].format);
+    }
+    NFREE(formatCache, "NStringFormat.clearCache() formatCache");
+    formatCache = 0;
+    formatCacheCapacity = 0;
+    formatCacheCount = 0;
+}
+
+static struct NString* vAppendCompiled(struct NString* outString, const struct NStringFormat* format, va_list vaList) {
+
+    if (!format) return outString;
+
+    // Reserve room for the whole text up front,
+    struct NByteVector *outVector = &outString->string;
+    NVectorSize estimatedSize = format->literals.size + format->argumentsCount * COMPILED_FORMAT_ARGUMENT_SIZE_ESTIMATE;
+    if (outVector->size + estimatedSize > outVector->capacity) NByteVector.ensureCapacity(outVector, estimatedSize);
+
+    // Pop the termination zero,
+    char tempChar;
+    NByteVector_popBack(outVector, (uint8_t*) &tempChar);
+
+    // Execute the segments,
+    va_list arguments;
+    va_copy(arguments, vaList);
+    const struct FormatSegment* segments = (const struct FormatSegment*) format->segments.objects;
+    NVectorSize segmentsCount = format->segments.objectsCount;
+    for (NVectorSize i=0; i<segmentsCount; i++) {
+        const struct FormatSegment* segment = &segments[i];
+        if (segment->literalLength) NByteVector_pushBackBulk(outVector, &format->literals.objects[segment->literalOffset], segment->literalLength);
+        if (segment->argument.type != FORMAT_ARGUMENT_NONE && !appendArgument(outVector, &segment->argument, &arguments)) break;
+    }
+    va_end(arguments);
+
     // Add the termination zero,
-    exit:
-    NByteVector.pushBack(outVector, 0);
+    NByteVector_pushBack(outVector, 0);
 
     return outString;
 }
 
+static struct NString* appendCompiled(struct NString* outString, const struct NStringFormat* format, ...) {
+    va_list vaList;
+    va_start(vaList, format);
+    vAppendCompiled(outString, format, vaList);
+    va_end(vaList);
+    return outString;
+}
+
 static struct NString* append(struct NString* outString, const char* format, ...) {
     va_list vaList;
     va_start(vaList, format);
@@ -382,9 +1334,27 @@ static struct NString* append(struct NString* outString, const char* format, ...
     return outString;
 }
 
+static struct NString* appendFloat(struct NString* outString, float value) {
+    struct NByteVector *outVector = &outString->string;
+    char tempChar;
+    NByteVector_popBack(outVector, (uint8_t*) &tempChar);
+    appendFloatToByteVector(outVector, value);
+    NByteVector_pushBack(outVector, 0);
+    return outString;
+}
+
+static struct NString* appendDouble(struct NString* outString, double value) {
+    struct NByteVector *outVector = &outString->string;
+    char tempChar;
+    NByteVector_popBack(outVector, (uint8_t*) &tempChar);
+    appendDoubleToByteVector(outVector, value);
+    NByteVector_pushBack(outVector, 0);
+    return outString;
+}
+
 static struct NString* set(struct NString* outString, const char* format, ...) {
     NByteVector.clear(&(outString->string));
-    NByteVector.pushBack(&outString->string, 0);
+    NByteVector_pushBack(&outString->string, 0);
 
     va_list vaList;
     va_start(vaList, format);
@@ -394,13 +1364,13 @@ static struct NString* set(struct NString* outString, const char* format, ...) {
 }
 
 static const char* get(struct NString* string) {
-    return (const char*) string->string.objects;
+    return NString_get(string);
 }
 
 static struct NString* trimFront(struct NString* string, const char* symbolsToBeRemoved) {
 
-    int32_t currentIndex=0;
-    int32_t symbolsCount = NCString.length(symbolsToBeRemoved);
+    NVectorIndex currentIndex=0;
+    int32_t symbolsCount = NCString_length(symbolsToBeRemoved);
     char* cString = (char*) string->string.objects;
     for (; cString[currentIndex]; currentIndex++) {
         boolean trimming = False;
@@ -417,7 +1387,7 @@ static struct NString* trimFront(struct NString* string, const char* symbolsToBe
     if (!currentIndex) return string;
 
     // Shift the string backwards to fill the gap,
-    int32_t i=0;
+    NVectorIndex i=0;
     while(cString[currentIndex]) cString[i++] = cString[currentIndex++];
 
     // Adjust the string size,
@@ -428,10 +1398,10 @@ static struct NString* trimFront(struct NString* string, const char* symbolsToBe
 }
 
 static struct NString* trimEnd(struct NString* string, const char* symbolsToBeRemoved) {
-    int32_t currentIndex = string->string.size-2;
+    NVectorIndex currentIndex = string->string.size-2;
     if ((!symbolsToBeRemoved[0]) || (currentIndex<0)) return string;
 
-    int32_t symbolsCount = NCString.length(symbolsToBeRemoved);
+    int32_t symbolsCount = NCString_length(symbolsToBeRemoved);
     char* cString = (char*) string->string.objects;
     for (; currentIndex>=0; currentIndex--) {
         boolean trimming = False;
@@ -462,44 +1432,58 @@ static struct NString* create(const char* format, ...) {
     struct NString* newString = NMALLOC(sizeof(struct NString), "NString.create() newString");
     va_list vaList;
     va_start(vaList, format);
-    vInitialize(newString, format, vaList);
+    vInitialize(newString, 0, 0, format, vaList);
     va_end(vaList);
     return newString;
 }
 
-static struct NString* replace(const char* textToBeSearched, const char* textToBeRemoved, const char* textToBeInserted) {
+static struct NString* appendReplaced(struct NString* outString, const char* textToBeSearched, const char* textToBeRemoved, const char* textToBeInserted) {
 
-    // Create a new string for the result,
-    struct NString* newString = NString.create("");
+    // Pop the termination zero,
+    struct NByteVector *outVector = &outString->string;
+    char tempChar;
+    NByteVector_popBack(outVector, (uint8_t*) &tempChar);
 
-    int32_t searchIndex=0;
-    char currentChar;
-    while ((currentChar = textToBeSearched[searchIndex])) {
+    // Unmatched text is appended in runs rather than character by character,
+    NVectorSize insertedTextLength = NCString_length(textToBeInserted);
+    NVectorSize searchIndex=0, runStartIndex=0;
+    while (textToBeSearched[searchIndex]) {
 
         // Attempt matching,
-        int32_t matchIndex=0;
+        NVectorSize matchIndex=0;
         while (textToBeRemoved[matchIndex] && textToBeSearched[searchIndex+matchIndex] &&
                textToBeRemoved[matchIndex] == textToBeSearched[searchIndex+matchIndex]) {
             matchIndex++;
         }
 
         // Either a match or a mismatch took place,
-        if (!textToBeRemoved[matchIndex]) {
-            // A match took place, append the text to be inserted,
-            NString.append(newString, "%s", textToBeInserted);
+        if (matchIndex && !textToBeRemoved[matchIndex]) {
+            // A match took place, flush the current run and append the text to be inserted,
+            NByteVector_pushBackBulk(outVector, &textToBeSearched[runStartIndex], searchIndex - runStartIndex);
+            NByteVector_pushBackBulk(outVector, textToBeInserted, insertedTextLength);
             searchIndex += matchIndex;
+            runStartIndex = searchIndex;
         } else {
-            // A mismatch took place, add the current character only and advance
-            // the search index by 1,
-            NString.append(newString, "%c", currentChar);
+            // A mismatch took place, advance the search index by 1,
             searchIndex++;
         }
     }
+    NByteVector_pushBackBulk(outVector, &textToBeSearched[runStartIndex], searchIndex - runStartIndex);
 
-    return newString;
+    // Add the termination zero,
+    NByteVector_pushBack(outVector, 0);
+
+    return outString;
 }
 
-static struct NString* subString(struct NString* string, int32_t startIndex, int32_t endIndex) {
+static struct NString* replace(const char* textToBeSearched, const char* textToBeRemoved, const char* textToBeInserted) {
+
+    // Create a new string for the result,
+    struct NString* newString = NString.create("");
+    return appendReplaced(newString, textToBeSearched, textToBeRemoved, textToBeInserted);
+}
+
+static struct NString* subString(struct NString* string, NVectorIndex startIndex, NVectorIndex endIndex) {
 
     // Create a new string for the result,
     struct NString* newString = NString.create("");
@@ -508,7 +1492,7 @@ static struct NString* subString(struct NString* string, int32_t startIndex, int
     // Copy,
     uint8_t* src  =    string->string.objects;
     uint8_t* dest = newString->string.objects;
-    for (int32_t i=startIndex; i<endIndex; i++) {
+    for (NVectorIndex i=startIndex; i<endIndex; i++) {
         *dest = src[i];
         dest++;
     }
@@ -519,8 +1503,16 @@ static struct NString* subString(struct NString* string, int32_t startIndex, int
     return newString;
 }
 
-static int32_t length(struct NString* string) {
-    return string->string.size - 1;
+static NVectorIndex length(struct NString* string) {
+    return NString_length(string);
+}
+
+static char* reserveWritable(struct NString* string, NVectorSize size) {
+    return NString_reserveWritable(string, size);
+}
+
+static boolean commit(struct NString* string, NVectorSize writtenSize) {
+    return NString_commit(string, writtenSize);
 }
 
 const struct NString_Interface NString = {
@@ -537,5 +1529,22 @@ const struct NString_Interface NString = {
     .create = create,
     .replace = replace,
     .subString = subString,
-    .length = length
+    .length = length,
+    .initializeWithBuffer = initializeWithBuffer,
+    .appendReplaced = appendReplaced,
+    .reserveWritable = reserveWritable,
+    .commit = commit,
+    .vAppendCompiled = vAppendCompiled,
+    .appendCompiled = appendCompiled,
+    .appendFloat = appendFloat,
+    .appendDouble = appendDouble
+};
+
+const struct NStringFormat_Interface NStringFormat = {
+    .initialize = initializeFormat,
+    .create = createFormat,
+    .destroy = destroyFormat,
+    .destroyAndFree = destroyAndFreeFormat,
+    .getCached = getCachedFormat,
+    .clearCache = clearFormatCache
 };
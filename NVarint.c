@@ -0,0 +1,202 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
+#include <NVarint.h>
+#include <NSystemUtils.h>
+
+#define CONTINUATION_BITS 0x8080808080808080ULL
+
+static uint64_t zigzagEncode(int64_t value) {
+    return NVarint_zigzagEncode(value);
+}
+
+static int64_t zigzagDecode(uint64_t value) {
+    return NVarint_zigzagDecode(value);
+}
+
+static int32_t size(uint64_t value) {
+    return NVarint_size(value);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Encoding
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Output must have room for NVARINT_MAX_SIZE bytes. Returns the written bytes count,
+static inline int32_t encode(uint8_t* output, uint64_t value) {
+    int32_t length=0;
+    while (value >= 0x80) {
+        output[length++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    output[length++] = (uint8_t) value;
+    return length;
+}
+
+static inline boolean pushBackEncoded(struct NByteVector* vector, uint64_t value) {
+    if ((vector->size + NVARINT_MAX_SIZE > vector->capacity) && !NByteVector.ensureCapacity(vector, NVARINT_MAX_SIZE)) return False;
+    vector->size += encode(&vector->objects[vector->size], value);
+    return True;
+}
+
+static boolean pushBack(struct NByteVector* vector, uint64_t value) {
+    return pushBackEncoded(vector, value);
+}
+
+static boolean pushBackSigned(struct NByteVector* vector, int64_t value) {
+    return pushBackEncoded(vector, NVarint_zigzagEncode(value));
+}
+
+static boolean pushBackBulk(struct NByteVector* vector, const uint64_t* values, NVectorSize valuesCount) {
+
+    // Reserve the exact size once,
+    NVectorSize encodedSize=0;
+    for (NVectorSize i=0; i<valuesCount; i++) encodedSize += NVarint_size(values[i]);
+    if (!NByteVector.ensureCapacity(vector, encodedSize)) return False;
+
+    uint8_t* output = &vector->objects[vector->size];
+    for (NVectorSize i=0; i<valuesCount; i++) output += encode(output, values[i]);
+    vector->size += encodedSize;
+
+    return True;
+}
+
+static boolean pushBackDeltas(struct NByteVector* vector, const uint64_t* sortedValues, NVectorSize valuesCount) {
+
+    // Reserve the exact size once. The first value is a delta from 0,
+    NVectorSize encodedSize=0;
+    uint64_t previousValue=0;
+    for (NVectorSize i=0; i<valuesCount; i++) {
+        if (sortedValues[i] < previousValue) return False;
+        encodedSize += NVarint_size(sortedValues[i] - previousValue);
+        previousValue = sortedValues[i];
+    }
+    if (!NByteVector.ensureCapacity(vector, encodedSize)) return False;
+
+    uint8_t* output = &vector->objects[vector->size];
+    previousValue=0;
+    for (NVectorSize i=0; i<valuesCount; i++) {
+        output += encode(output, sortedValues[i] - previousValue);
+        previousValue = sortedValues[i];
+    }
+    vector->size += encodedSize;
+
+    return True;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Decoding
+/////////////////////////////////////////////////////////////////////////////////////
+
+static inline NVectorSize decodeOne(const uint8_t* data, NVectorSize dataSize, uint64_t* outputValue) {
+    uint64_t value=0;
+    NVectorSize maxLength = (dataSize < NVARINT_MAX_SIZE) ? dataSize : NVARINT_MAX_SIZE;
+    for (NVectorSize i=0; i<maxLength; i++) {
+        uint8_t currentByte = data[i];
+        value |= ((uint64_t) (currentByte & 0x7f)) << (7*i);
+        if (!(currentByte & 0x80)) {
+            // The 10th byte may only hold the last bit,
+            if ((i == NVARINT_MAX_SIZE-1) && (currentByte > 1)) return 0;
+            *outputValue = value;
+            return i+1;
+        }
+    }
+    return 0;
+}
+
+static NVectorSize decode(const void* data, NVectorSize dataSize, uint64_t* outputValue) {
+    return decodeOne(data, dataSize, outputValue);
+}
+
+static NVectorSize decodeSigned(const void* data, NVectorSize dataSize, int64_t* outputValue) {
+    uint64_t value;
+    NVectorSize length = decodeOne(data, dataSize, &value);
+    if (length) *outputValue = NVarint_zigzagDecode(value);
+    return length;
+}
+
+// Drops the continuation bits of a value encoded in the lowest length bytes of word,
+static inline uint64_t compactWord(uint64_t word, int32_t length) {
+    if (length < 8) word &= (((uint64_t) 1) << (length*8)) - 1;
+    return  (word        & 0x000000000000007fULL) |
+           ((word >>  1) & 0x0000000000003f80ULL) |
+           ((word >>  2) & 0x00000000001fc000ULL) |
+           ((word >>  3) & 0x000000000fe00000ULL) |
+           ((word >>  4) & 0x00000007f0000000ULL) |
+           ((word >>  5) & 0x000003f800000000ULL) |
+           ((word >>  6) & 0x0001fc0000000000ULL) |
+           ((word >>  7) & 0x00fe000000000000ULL);
+}
+
+// Decodes a word (8 bytes) at a time where possible. Runs of 8 single byte values (the common case
+// for small integers) are detected with a single test and widened at once, values up to 8 bytes
+// long are decoded without a loop. The rest falls back to decoding byte by byte,
+static inline NVectorSize decodeBulkInline(const uint8_t* data, NVectorSize dataSize, uint64_t* outputValues, NVectorSize valuesCount, boolean deltas) {
+    NVectorSize offset=0, decodedCount=0;
+    uint64_t previousValue=0;
+    while (decodedCount < valuesCount) {
+        uint64_t value;
+
+        #if !NBYTEVECTOR_BIG_ENDIAN_HOST
+        if (dataSize - offset >= 8) {
+            uint64_t word;
+            NSTDLIB_INLINE_MEMCPY(&word, &data[offset], 8);
+            uint64_t terminators = ~word & CONTINUATION_BITS;
+
+            // 8 single byte values,
+            if ((terminators == CONTINUATION_BITS) && (valuesCount - decodedCount >= 8)) {
+                for (int32_t i=0; i<8; i++) {
+                    value = data[offset+i];
+                    if (deltas) value = previousValue += value;
+                    outputValues[decodedCount+i] = value;
+                }
+                offset += 8;
+                decodedCount += 8;
+                continue;
+            }
+
+            // A value that ends within the word,
+            if (terminators) {
+                int32_t length = (__builtin_ctzll(terminators) >> 3) + 1;
+                value = compactWord(word, length);
+                if (deltas) value = previousValue += value;
+                outputValues[decodedCount++] = value;
+                offset += length;
+                continue;
+            }
+        }
+        #endif
+
+        // Near the end of the data, or a value longer than 8 bytes,
+        NVectorSize length = decodeOne(&data[offset], dataSize - offset, &value);
+        if (!length) return 0;
+        if (deltas) value = previousValue += value;
+        outputValues[decodedCount++] = value;
+        offset += length;
+    }
+
+    return offset;
+}
+
+static NVectorSize decodeBulk(const void* data, NVectorSize dataSize, uint64_t* outputValues, NVectorSize valuesCount) {
+    return decodeBulkInline(data, dataSize, outputValues, valuesCount, False);
+}
+
+static NVectorSize decodeDeltas(const void* data, NVectorSize dataSize, uint64_t* outputValues, NVectorSize valuesCount) {
+    return decodeBulkInline(data, dataSize, outputValues, valuesCount, True);
+}
+
+const struct NVarint_Interface NVarint = {
+    .zigzagEncode = zigzagEncode,
+    .zigzagDecode = zigzagDecode,
+    .size = size,
+    .pushBack = pushBack,
+    .pushBackSigned = pushBackSigned,
+    .decode = decode,
+    .decodeSigned = decodeSigned,
+    .pushBackBulk = pushBackBulk,
+    .decodeBulk = decodeBulk,
+    .pushBackDeltas = pushBackDeltas,
+    .decodeDeltas = decodeDeltas
+};
@@ -1,11 +1,25 @@
+// The library always uses its own inline fast paths,
+#undef NSTDLIB_INLINE
+#define NSTDLIB_INLINE 1
+
 #include <NVector.h>
 #include <NSystemUtils.h>
 
-#define NVECTOR_BOUNDARY_CHECK 1
+#if defined(__x86_64__) || defined(__i386__)
+    #define NVECTOR_X86_SIMD 1
+    #include <immintrin.h>
+#else
+    #define NVECTOR_X86_SIMD 0
+#endif
+
+// False if the size of capacity objects can't be represented (overflows),
+static inline boolean isValidCapacity(NVectorSize capacity, uint32_t objectSize) {
+    return capacity <= NVECTOR_MAX_ALLOCATION_SIZE / objectSize;
+}
 
-static struct NVector* initialize(struct NVector* outputVector, uint32_t initialCapacity, uint32_t objectSize) {
+static struct NVector* initialize(struct NVector* outputVector, NVectorSize initialCapacity, uint32_t objectSize) {
 
-    if (objectSize==0) return 0;
+    if ((objectSize==0) || !isValidCapacity(initialCapacity, objectSize)) return 0;
 
     NSystemUtils.memset(outputVector, 0, sizeof(struct NVector));
 
@@ -18,9 +32,9 @@ static struct NVector* initialize(struct NVector* outputVector, uint32_t initial
     return outputVector;
 }
 
-static struct NVector* create(uint32_t initialCapacity, uint32_t objectSize) {
+static struct NVector* create(NVectorSize initialCapacity, uint32_t objectSize) {
 
-    if (objectSize==0) return 0;
+    if ((objectSize==0) || !isValidCapacity(initialCapacity, objectSize)) return 0;
 
     struct NVector* newVector = NMALLOC(sizeof(struct NVector), "NVector.create() newVector");
     return initialize(newVector, initialCapacity, objectSize);
@@ -33,7 +47,7 @@ static struct NVector* initializeFrom(struct NVector* outputVector, struct NVect
 
     //  Allocate separate storage (if needed),
     if (vectorToCopy->capacity) {
-        int32_t vectorSizeBytes = vectorToCopy->capacity * vectorToCopy->objectSize;
+        int64_t vectorSizeBytes = vectorToCopy->capacity * (int64_t) vectorToCopy->objectSize;
         outputVector->objects = NMALLOC(vectorSizeBytes, "NVector.initializeFrom() outputVector->objects");
 
         // Copy data,
@@ -58,94 +72,303 @@ static struct NVector* clear(struct NVector* vector) {
     return vector;
 }
 
-static boolean grow(struct NVector* vector, uint32_t newCapacity) {
+static struct NVector* setGrowthPolicy(struct NVector* vector, int32_t growthPolicy) {
+    vector->growthPolicy = growthPolicy;
+    return vector;
+}
+
+static boolean grow(struct NVector* vector, NVectorSize newCapacity) {
 
     if (newCapacity <= vector->capacity) return True;
+    if (!isValidCapacity(newCapacity, vector->objectSize)) return False;
 
-    uint32_t newSizeBytes = newCapacity * vector->objectSize;
-    void *newArray = NMALLOC(newSizeBytes, "NVector.grow() newArray");
+    // Reallocate. This grows the block in place whenever possible, avoiding the copy,
+    int64_t newSizeBytes = newCapacity * (int64_t) vector->objectSize;
+    void *newArray = NREALLOC(vector->objects, newSizeBytes, "NVector.grow() vector->objects");
     if (!newArray) return False;
 
-    if (vector->objects) {
-        uint32_t originalSizeBytes = vector->objectsCount * vector->objectSize;
-        NSystemUtils.memcpy(newArray, vector->objects, originalSizeBytes);
-        NFREE(vector->objects, "NVector.grow() vector->objects");
-    }
-
     vector->objects = newArray;
     vector->capacity = newCapacity;
 
     return True;
 }
 
-static boolean expand(struct NVector* vector) {
-    if (vector->capacity == 0) {
-        vector->objects = NMALLOC(vector->objectSize, "NVector.expand() vector->objects");
-        if (!vector->objects) return False;
-        vector->capacity = 1;
-        return True;
-    }
-    return grow(vector, vector->capacity<<1);
-}
+static boolean ensureCapacity(struct NVector* vector, NVectorSize additionalCapacity) {
 
-static void* emplaceBack(struct NVector* vector) {
-
-    // Double the vector capacity if needed,
-    if ((vector->objectsCount == vector->capacity) && !expand(vector)) return 0;
+    // Maybe we needn't do anything,
+    NVectorSize requiredCapacity = vector->objectsCount + additionalCapacity;
+    if (requiredCapacity < additionalCapacity) return False; // Overflow.
+    if (requiredCapacity <= vector->capacity) return True;
 
-    // Make way for a new entry,
-    void *newObjectPointer = (void *)(((intptr_t) vector->objects) + (vector->objectsCount * vector->objectSize));
-    vector->objectsCount++;
+    // Grow according to the growth policy,
+    NVectorSize newCapacity = NGrowthPolicy.getNewCapacity(vector->growthPolicy, vector->capacity, requiredCapacity, vector->objectSize);
+    return newCapacity && grow(vector, newCapacity);
+}
 
-    return newObjectPointer;
+static void* emplaceBack(struct NVector* vector) {
+    return NVector_emplaceBack(vector);
 }
 
 static boolean pushBack(struct NVector* vector, const void *object) {
+    return NVector_pushBack(vector, object);
+}
 
-    // Double the vector capacity if needed,
-    if ((vector->objectsCount == vector->capacity) && !expand(vector)) return False;
+static boolean pushBackBulk(struct NVector* vector, const void *objects, NVectorSize objectsCount) {
 
-    // Push the value,
-    void *newObjectPointer = (void *)(((intptr_t) vector->objects) + (vector->objectsCount * vector->objectSize));
-    NSystemUtils.memcpy(newObjectPointer, object, vector->objectSize);
-    vector->objectsCount++;
+    // Objects taken from this same vector are tracked by offset, since growing may move them,
+    intptr_t sourceOffset = ((intptr_t) objects) - ((intptr_t) vector->objects);
+    boolean isFromThisVector = vector->objects && (sourceOffset >= 0) && (sourceOffset < (intptr_t) (vector->objectsCount * vector->objectSize));
+
+    // Reserve once,
+    if (!ensureCapacity(vector, objectsCount)) return False;
+    if (isFromThisVector) objects = (void*) (((intptr_t) vector->objects) + sourceOffset);
+
+    // Copy all the objects at once,
+    intptr_t dest = ((intptr_t) vector->objects) + (vector->objectsCount * vector->objectSize);
+    NSystemUtils.memcpy((void*) dest, objects, objectsCount * vector->objectSize);
+    vector->objectsCount += objectsCount;
 
     return True;
 }
 
-static boolean popBack(struct NVector* vector, void *outputObject) {
-    if (vector->objectsCount==0) return False;
+static boolean insertRange(struct NVector* vector, NVectorSize index, const void *objects, NVectorSize objectsCount) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if (index > vector->objectsCount) return False;
+    #endif
 
-    vector->objectsCount--;
-    void *lastObjectPointer = (void *)(((intptr_t) vector->objects) + (vector->objectsCount * vector->objectSize));
-    NSystemUtils.memcpy(outputObject, lastObjectPointer, vector->objectSize);
+    // Objects taken from this same vector are tracked by offset, since growing may move them,
+    intptr_t sourceOffset = ((intptr_t) objects) - ((intptr_t) vector->objects);
+    boolean isFromThisVector = vector->objects && (sourceOffset >= 0) && (sourceOffset < (intptr_t) (vector->objectsCount * vector->objectSize));
+
+    // Reserve once,
+    if (!ensureCapacity(vector, objectsCount)) return False;
+
+    // Make way for the new objects, then copy them,
+    intptr_t dest = ((intptr_t) vector->objects) + (index * vector->objectSize);
+    NVectorSize shiftSizeBytes = (vector->objectsCount - index) * vector->objectSize;
+    NVectorSize insertedSizeBytes = objectsCount * vector->objectSize;
+    if (shiftSizeBytes) NSystemUtils.memmove((void*)(dest + insertedSizeBytes), (void*) dest, shiftSizeBytes);
+    if (isFromThisVector) {
+        // The source part before the insertion point stayed, the part after it moved with the shift,
+        intptr_t source = ((intptr_t) vector->objects) + sourceOffset;
+        NVectorSize unmovedSizeBytes = (source < dest) ? (NVectorSize) (dest - source) : 0;
+        if (unmovedSizeBytes > insertedSizeBytes) unmovedSizeBytes = insertedSizeBytes;
+        NSystemUtils.memcpy((void*) dest, (void*) source, unmovedSizeBytes);
+        NSystemUtils.memcpy((void*) (dest + unmovedSizeBytes), (void*) (source + unmovedSizeBytes + insertedSizeBytes), insertedSizeBytes - unmovedSizeBytes);
+    } else {
+        NSystemUtils.memcpy((void*) dest, objects, insertedSizeBytes);
+    }
+    vector->objectsCount += objectsCount;
 
     return True;
 }
 
-static void* get(struct NVector* vector, uint32_t index) {
-    #if NVECTOR_BOUNDARY_CHECK
-    if (index >= vector->objectsCount) return 0;
-    #endif
+static boolean popBack(struct NVector* vector, void *outputObject) {
+    return NVector_popBack(vector, outputObject);
+}
 
-    return (void *)(((intptr_t) vector->objects) + (index                    * vector->objectSize));
+static void* get(struct NVector* vector, NVectorSize index) {
+    return NVector_get(vector, index);
 }
 
 static void* getLast(struct NVector* vector) {
-    if (!vector->objectsCount) return 0;
-    return (void *)(((intptr_t) vector->objects) + ((vector->objectsCount-1) * vector->objectSize));
+    return NVector_getLast(vector);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Search kernels
+/////////////////////////////////////////////////////////////////////////////////////
+
+// Objects of sizes 1, 2, 4, 8 and 16 bytes are compared many at a time. Blocks of bytes are
+// compared against a pattern made of the searched object repeated, and an object matches if all
+// its bytes do. Other sizes fall back to comparing one object at a time.
+
+#define SEARCH_PATTERN_SIZE 32
+
+static inline boolean isSearchKernelSize(uint32_t objectSize) {
+    return (objectSize <= 16) && !(objectSize & (objectSize-1));
+}
+
+// Turns a mask of equal bytes into a mask with the first bit of every fully equal object set,
+static inline uint32_t reduceEqualBytesMask(uint32_t mask, uint32_t objectSize) {
+    switch (objectSize) {
+        case  1: return mask;
+        case  2: mask &= mask>>1; return mask & 0x55555555;
+        case  4: mask &= mask>>1; mask &= mask>>2; return mask & 0x11111111;
+        case  8: mask &= mask>>1; mask &= mask>>2; mask &= mask>>4; return mask & 0x01010101;
+        default: mask &= mask>>1; mask &= mask>>2; mask &= mask>>4; mask &= mask>>8; return mask & 0x00010001;
+    }
+}
+
+static inline boolean objectEquals(const uint8_t* object, const uint8_t* pattern, uint32_t objectSize) {
+    switch (objectSize) {
+        case  1: return *object == *pattern;
+        case  2: { uint16_t a, b; NSTDLIB_INLINE_MEMCPY(&a, object, 2); NSTDLIB_INLINE_MEMCPY(&b, pattern, 2); return a == b; }
+        case  4: { uint32_t a, b; NSTDLIB_INLINE_MEMCPY(&a, object, 4); NSTDLIB_INLINE_MEMCPY(&b, pattern, 4); return a == b; }
+        case  8: { uint64_t a, b; NSTDLIB_INLINE_MEMCPY(&a, object, 8); NSTDLIB_INLINE_MEMCPY(&b, pattern, 8); return a == b; }
+        case 16: {
+            uint64_t a[2], b[2];
+            NSTDLIB_INLINE_MEMCPY(a, object, 16);
+            NSTDLIB_INLINE_MEMCPY(b, pattern, 16);
+            return (a[0] == b[0]) && (a[1] == b[1]);
+        }
+        default: return !NSystemUtils.memcmp(object, pattern, objectSize);
+    }
 }
 
-static int32_t getFirstInstanceIndex(struct NVector* vector, const void* object) {
-    intptr_t currentLocation = (intptr_t) vector->objects;
-    for (int32_t i=0; i<vector->objectsCount; i++) {
-        if (!NSystemUtils.memcmp(object, (void*) currentLocation, vector->objectSize)) return i;
-        currentLocation += vector->objectSize;
+static NVectorIndex findScalar(const uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, const uint8_t* pattern) {
+    for (NVectorSize i=0; i<objectsCount; i++) {
+        if (objectEquals(&objects[i * objectSize], pattern, objectSize)) return i;
     }
     return -1;
 }
 
-static void remove(struct NVector* vector, int32_t index) {
+static NVectorSize countScalar(const uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, const uint8_t* pattern) {
+    NVectorSize count=0;
+    for (NVectorSize i=0; i<objectsCount; i++) count += objectEquals(&objects[i * objectSize], pattern, objectSize);
+    return count;
+}
+
+#if NVECTOR_X86_SIMD
+
+__attribute__((target("sse2")))
+static NVectorIndex findSSE2(const uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, const uint8_t* pattern) {
+    NVectorSize sizeBytes = objectsCount * objectSize;
+    __m128i patternVector = _mm_loadu_si128((const __m128i*) pattern);
+    NVectorSize offset=0;
+    for (; offset+16 <= sizeBytes; offset+=16) {
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) &objects[offset]), patternVector));
+        mask = reduceEqualBytesMask(mask, objectSize);
+        if (mask) return (offset + __builtin_ctz(mask)) / objectSize;
+    }
+    NVectorIndex index = findScalar(&objects[offset], (sizeBytes - offset) / objectSize, objectSize, pattern);
+    return (index < 0) ? -1 : (NVectorIndex) (offset / objectSize) + index;
+}
+
+__attribute__((target("sse2")))
+static NVectorSize countSSE2(const uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, const uint8_t* pattern) {
+    NVectorSize sizeBytes = objectsCount * objectSize;
+    __m128i patternVector = _mm_loadu_si128((const __m128i*) pattern);
+    NVectorSize offset=0, count=0;
+    for (; offset+16 <= sizeBytes; offset+=16) {
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) &objects[offset]), patternVector));
+        count += __builtin_popcount(reduceEqualBytesMask(mask, objectSize));
+    }
+    return count + countScalar(&objects[offset], (sizeBytes - offset) / objectSize, objectSize, pattern);
+}
+
+__attribute__((target("avx2,popcnt")))
+static NVectorIndex findAVX2(const uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, const uint8_t* pattern) {
+    NVectorSize sizeBytes = objectsCount * objectSize;
+    __m256i patternVector = _mm256_loadu_si256((const __m256i*) pattern);
+    NVectorSize offset=0;
+
+    // Two blocks per iteration, checked together,
+    for (; offset+64 <= sizeBytes; offset+=64) {
+        __m256i equal1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) &objects[offset   ]), patternVector);
+        __m256i equal2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) &objects[offset+32]), patternVector);
+        uint32_t mask1 = reduceEqualBytesMask((uint32_t) _mm256_movemask_epi8(equal1), objectSize);
+        uint32_t mask2 = reduceEqualBytesMask((uint32_t) _mm256_movemask_epi8(equal2), objectSize);
+        if (mask1 | mask2) {
+            if (mask1) return (offset      + __builtin_ctz(mask1)) / objectSize;
+            return            (offset + 32 + __builtin_ctz(mask2)) / objectSize;
+        }
+    }
+    for (; offset+32 <= sizeBytes; offset+=32) {
+        uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) &objects[offset]), patternVector));
+        mask = reduceEqualBytesMask(mask, objectSize);
+        if (mask) return (offset + __builtin_ctz(mask)) / objectSize;
+    }
+    NVectorIndex index = findScalar(&objects[offset], (sizeBytes - offset) / objectSize, objectSize, pattern);
+    return (index < 0) ? -1 : (NVectorIndex) (offset / objectSize) + index;
+}
+
+__attribute__((target("avx2,popcnt")))
+static NVectorSize countAVX2(const uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, const uint8_t* pattern) {
+    NVectorSize sizeBytes = objectsCount * objectSize;
+    __m256i patternVector = _mm256_loadu_si256((const __m256i*) pattern);
+    NVectorSize offset=0, count=0;
+    for (; offset+32 <= sizeBytes; offset+=32) {
+        uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) &objects[offset]), patternVector));
+        count += __builtin_popcount(reduceEqualBytesMask(mask, objectSize));
+    }
+    return count + countScalar(&objects[offset], (sizeBytes - offset) / objectSize, objectSize, pattern);
+}
+
+#endif
+
+// 0: scalar, 1: SSE2, 2: AVX2. Detected once at runtime,
+static int32_t simdLevel=-1;
+static inline int32_t getSIMDLevel() {
+    if (simdLevel < 0) {
+        #if NVECTOR_X86_SIMD
+            __builtin_cpu_init();
+            simdLevel = __builtin_cpu_supports("avx2") ? 2 : (__builtin_cpu_supports("sse2") ? 1 : 0);
+        #else
+            simdLevel = 0;
+        #endif
+    }
+    return simdLevel;
+}
+
+static inline void fillSearchPattern(uint8_t* pattern, const void* object, uint32_t objectSize) {
+    for (uint32_t i=0; i<SEARCH_PATTERN_SIZE; i+=objectSize) NSTDLIB_INLINE_MEMCPY(&pattern[i], object, objectSize);
+}
+
+static NVectorIndex findFirstInstance(const uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, const void* object) {
+
+    if (!isSearchKernelSize(objectSize)) return findScalar(objects, objectsCount, objectSize, object);
+
+    uint8_t pattern[SEARCH_PATTERN_SIZE];
+    fillSearchPattern(pattern, object, objectSize);
+    #if NVECTOR_X86_SIMD
+        switch (getSIMDLevel()) {
+            case 2: return findAVX2(objects, objectsCount, objectSize, pattern);
+            case 1: return findSSE2(objects, objectsCount, objectSize, pattern);
+        }
+    #endif
+    return findScalar(objects, objectsCount, objectSize, pattern);
+}
+
+static NVectorIndex getFirstInstanceIndex(struct NVector* vector, const void* object) {
+    return findFirstInstance(vector->objects, vector->objectsCount, vector->objectSize, object);
+}
+
+static NVectorSize countInstances(struct NVector* vector, const void* object) {
+
+    if (!isSearchKernelSize(vector->objectSize)) return countScalar(vector->objects, vector->objectsCount, vector->objectSize, object);
+
+    uint8_t pattern[SEARCH_PATTERN_SIZE];
+    fillSearchPattern(pattern, object, vector->objectSize);
+    #if NVECTOR_X86_SIMD
+        switch (getSIMDLevel()) {
+            case 2: return countAVX2(vector->objects, vector->objectsCount, vector->objectSize, pattern);
+            case 1: return countSSE2(vector->objects, vector->objectsCount, vector->objectSize, pattern);
+        }
+    #endif
+    return countScalar(vector->objects, vector->objectsCount, vector->objectSize, pattern);
+}
+
+static NVectorSize findAllInstances(struct NVector* vector, const void* object, struct NVector* outIndices) {
+
+    if (outIndices->objectSize != sizeof(NVectorSize)) return 0;
+
+    // Keep searching right after the last found instance,
+    uint8_t* objects = vector->objects;
+    NVectorSize foundCount=0, startIndex=0;
+    while (startIndex < vector->objectsCount) {
+        NVectorIndex index = findFirstInstance(&objects[startIndex * vector->objectSize], vector->objectsCount - startIndex, vector->objectSize, object);
+        if (index < 0) break;
+        startIndex += index;
+        if (!NVector_pushBack(outIndices, &startIndex)) break;
+        foundCount++;
+        startIndex++;
+    }
+
+    return foundCount;
+}
+
+static void remove(struct NVector* vector, NVectorIndex index) {
     #if NVECTOR_BOUNDARY_CHECK
     if (index < 0 | index >= vector->objectsCount) return;
     #endif
@@ -155,16 +378,334 @@ static void remove(struct NVector* vector, int32_t index) {
     NSystemUtils.memmove((void*) dest, (void*)(dest + vector->objectSize), (vector->objectsCount - index)*vector->objectSize);
 }
 
-static uint32_t size(struct NVector* vector) {
-    return vector->objectsCount;
+static void removeRange(struct NVector* vector, NVectorSize startIndex, NVectorSize objectsCount) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if ((startIndex > vector->objectsCount) || (objectsCount > vector->objectsCount - startIndex)) return;
+    #endif
+
+    // Close the gap with a single move,
+    intptr_t dest = ((intptr_t) vector->objects) + (startIndex * vector->objectSize);
+    NVectorSize removedSizeBytes = objectsCount * vector->objectSize;
+    NVectorSize shiftSizeBytes = (vector->objectsCount - startIndex - objectsCount) * vector->objectSize;
+    if (shiftSizeBytes) NSystemUtils.memmove((void*) dest, (void*)(dest + removedSizeBytes), shiftSizeBytes);
+    vector->objectsCount -= objectsCount;
+}
+
+static NVectorSize removeIf(struct NVector* vector, boolean (*predicate)(void* object, void* context), void* context) {
+
+    // Single pass compaction. Runs of kept objects are moved together once the run ends,
+    uint8_t* objects = vector->objects;
+    uint32_t objectSize = vector->objectSize;
+    NVectorSize writeIndex=0, runStartIndex=0;
+    for (NVectorSize i=0; i<vector->objectsCount; i++) {
+        if (!predicate(&objects[i * objectSize], context)) continue;
+
+        // Move the run of kept objects preceding this one,
+        NVectorSize runLength = i - runStartIndex;
+        if (runLength && (writeIndex != runStartIndex)) {
+            NSystemUtils.memmove(&objects[writeIndex * objectSize], &objects[runStartIndex * objectSize], runLength * objectSize);
+        }
+        writeIndex += runLength;
+        runStartIndex = i+1;
+    }
+
+    // Move the last run,
+    NVectorSize runLength = vector->objectsCount - runStartIndex;
+    if (runLength && (writeIndex != runStartIndex)) {
+        NSystemUtils.memmove(&objects[writeIndex * objectSize], &objects[runStartIndex * objectSize], runLength * objectSize);
+    }
+    writeIndex += runLength;
+
+    NVectorSize removedObjectsCount = vector->objectsCount - writeIndex;
+    vector->objectsCount = writeIndex;
+    return removedObjectsCount;
+}
+
+static void swapRemove(struct NVector* vector, NVectorIndex index) {
+    #if NVECTOR_BOUNDARY_CHECK
+    if ((index < 0) || ((NVectorSize) index >= vector->objectsCount)) return;
+    #endif
+
+    vector->objectsCount--;
+    if ((NVectorSize) index == vector->objectsCount) return;
+    intptr_t dest = ((intptr_t) vector->objects) + (index * vector->objectSize);
+    intptr_t last = ((intptr_t) vector->objects) + (vector->objectsCount * vector->objectSize);
+    NSystemUtils.memcpy((void*) dest, (void*) last, vector->objectSize);
+}
+
+static NVectorSize size(struct NVector* vector) {
+    return NVector_size(vector);
 }
 
-static boolean resize(struct NVector* vector, uint32_t newSize) {
-    if (newSize > vector->capacity && !grow(vector, newSize)) return False;
+static boolean resize(struct NVector* vector, NVectorSize newSize) {
+    if ((newSize > vector->objectsCount) && !ensureCapacity(vector, newSize - vector->objectsCount)) return False;
     vector->objectsCount = newSize;
     return True;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+// Sorting and searching
+/////////////////////////////////////////////////////////////////////////////////////
+
+#define INSERTION_SORT_THRESHOLD 16
+#define SWAP_CHUNK_SIZE 64
+
+typedef int32_t (*Comparator)(const void* object1, const void* object2);
+
+static inline void swapObjects(uint8_t* object1, uint8_t* object2, uint32_t objectSize) {
+
+    // Swap in chunks, so that no allocation is needed regardless of the object size,
+    uint8_t temp[SWAP_CHUNK_SIZE];
+    while (objectSize) {
+        uint32_t chunkSize = (objectSize < SWAP_CHUNK_SIZE) ? objectSize : SWAP_CHUNK_SIZE;
+        NSTDLIB_INLINE_MEMCPY(temp, object1, chunkSize);
+        NSTDLIB_INLINE_MEMCPY(object1, object2, chunkSize);
+        NSTDLIB_INLINE_MEMCPY(object2, temp, chunkSize);
+        object1 += chunkSize;
+        object2 += chunkSize;
+        objectSize -= chunkSize;
+    }
+}
+
+static void insertionSort(uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, Comparator comparator) {
+    for (NVectorSize i=1; i<objectsCount; i++) {
+        uint8_t* current = &objects[i * objectSize];
+        while ((current != objects) && (comparator(current - objectSize, current) > 0)) {
+            swapObjects(current - objectSize, current, objectSize);
+            current -= objectSize;
+        }
+    }
+}
+
+static void siftDown(uint8_t* objects, NVectorSize rootIndex, NVectorSize objectsCount, uint32_t objectSize, Comparator comparator) {
+    NVectorSize childIndex;
+    while ((childIndex = (rootIndex<<1) + 1) < objectsCount) {
+        if ((childIndex+1 < objectsCount) && (comparator(&objects[childIndex * objectSize], &objects[(childIndex+1) * objectSize]) < 0)) childIndex++;
+        if (comparator(&objects[rootIndex * objectSize], &objects[childIndex * objectSize]) >= 0) return;
+        swapObjects(&objects[rootIndex * objectSize], &objects[childIndex * objectSize], objectSize);
+        rootIndex = childIndex;
+    }
+}
+
+static void heapSort(uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, Comparator comparator) {
+    for (NVectorSize i=objectsCount>>1; i>0; i--) siftDown(objects, i-1, objectsCount, objectSize, comparator);
+    for (NVectorSize i=objectsCount-1; i>0; i--) {
+        swapObjects(objects, &objects[i * objectSize], objectSize);
+        siftDown(objects, 0, i, objectSize, comparator);
+    }
+}
+
+static void introSort(uint8_t* objects, NVectorSize objectsCount, uint32_t objectSize, Comparator comparator, int32_t depthLimit) {
+
+    while (objectsCount > INSERTION_SORT_THRESHOLD) {
+
+        // Fall back to heap sort if partitioning keeps going badly,
+        if (!depthLimit--) {
+            heapSort(objects, objectsCount, objectSize, comparator);
+            return;
+        }
+
+        // Median of three, moved to the first position to be used as the pivot,
+        uint8_t* first = objects;
+        uint8_t* middle = &objects[(objectsCount>>1) * objectSize];
+        uint8_t* last = &objects[(objectsCount-1) * objectSize];
+        if (comparator(middle, first ) < 0) swapObjects(middle, first , objectSize);
+        if (comparator(last  , first ) < 0) swapObjects(last  , first , objectSize);
+        if (comparator(last  , middle) < 0) swapObjects(last  , middle, objectSize);
+        swapObjects(first, middle, objectSize);
+
+        // Partition. Stopping on equal objects keeps the partitions balanced with many duplicates,
+        NVectorSize i=0, j=objectsCount;
+        while (True) {
+            while (comparator(&objects[(++i) * objectSize], first) < 0) if (i == objectsCount-1) break;
+            while (comparator(first, &objects[(--j) * objectSize]) < 0) if (j == 0) break;
+            if (i >= j) break;
+            swapObjects(&objects[i * objectSize], &objects[j * objectSize], objectSize);
+        }
+        swapObjects(first, &objects[j * objectSize], objectSize);
+
+        // Recurse into the smaller partition, loop on the larger one,
+        NVectorSize leftCount = j;
+        NVectorSize rightCount = objectsCount - j - 1;
+        if (leftCount < rightCount) {
+            introSort(objects, leftCount, objectSize, comparator, depthLimit);
+            objects = &objects[(j+1) * objectSize];
+            objectsCount = rightCount;
+        } else {
+            introSort(&objects[(j+1) * objectSize], rightCount, objectSize, comparator, depthLimit);
+            objectsCount = leftCount;
+        }
+    }
+
+    insertionSort(objects, objectsCount, objectSize, comparator);
+}
+
+static void sort(struct NVector* vector, Comparator comparator) {
+
+    // Depth limit is 2*log2(n),
+    int32_t depthLimit=0;
+    for (NVectorSize count=vector->objectsCount; count; count>>=1) depthLimit += 2;
+
+    introSort(vector->objects, vector->objectsCount, vector->objectSize, comparator, depthLimit);
+}
+
+static boolean stableSort(struct NVector* vector, Comparator comparator) {
+
+    NVectorSize objectsCount = vector->objectsCount;
+    uint32_t objectSize = vector->objectSize;
+    if (objectsCount < 2) return True;
+
+    // Sort small runs using insertion sort (which is stable),
+    uint8_t* source = vector->objects;
+    for (NVectorSize runStart=0; runStart<objectsCount; runStart+=INSERTION_SORT_THRESHOLD) {
+        NVectorSize runLength = objectsCount - runStart;
+        if (runLength > INSERTION_SORT_THRESHOLD) runLength = INSERTION_SORT_THRESHOLD;
+        insertionSort(&source[runStart * objectSize], runLength, objectSize, comparator);
+    }
+    if (objectsCount <= INSERTION_SORT_THRESHOLD) return True;
+
+    // Bottom-up merging, ping-ponging between the vector and a temporary buffer,
+    uint8_t* buffer = NMALLOC(objectsCount * (int64_t) objectSize, "NVector.stableSort() buffer");
+    if (!buffer) return False;
+    uint8_t* destination = buffer;
+    for (NVectorSize width=INSERTION_SORT_THRESHOLD; width<objectsCount; width<<=1) {
+        for (NVectorSize leftStart=0; leftStart<objectsCount; leftStart+=width<<1) {
+            NVectorSize leftEnd = leftStart + width;
+            if (leftEnd > objectsCount) leftEnd = objectsCount;
+            NVectorSize rightEnd = leftEnd + width;
+            if (rightEnd > objectsCount) rightEnd = objectsCount;
+
+            // Merge. Taking from the left on ties keeps the sort stable,
+            NVectorSize left=leftStart, right=leftEnd, output=leftStart;
+            while ((left < leftEnd) && (right < rightEnd)) {
+                if (comparator(&source[right * objectSize], &source[left * objectSize]) < 0) {
+                    NSTDLIB_INLINE_MEMCPY(&destination[(output++) * objectSize], &source[(right++) * objectSize], objectSize);
+                } else {
+                    NSTDLIB_INLINE_MEMCPY(&destination[(output++) * objectSize], &source[(left++) * objectSize], objectSize);
+                }
+            }
+            if (left  <  leftEnd) NSystemUtils.memcpy(&destination[output * objectSize], &source[left  * objectSize], ( leftEnd - left ) * objectSize);
+            if (right < rightEnd) NSystemUtils.memcpy(&destination[output * objectSize], &source[right * objectSize], (rightEnd - right) * objectSize);
+        }
+
+        uint8_t* temp = source;
+        source = destination;
+        destination = temp;
+    }
+
+    // Make sure the result ends up in the vector,
+    if (source != vector->objects) NSystemUtils.memcpy(vector->objects, source, objectsCount * (int64_t) objectSize);
+    NFREE(buffer, "NVector.stableSort() buffer");
+
+    return True;
+}
+
+static inline uint64_t readRadixKey(const uint8_t* object, uint32_t keySize, uint64_t signFlip) {
+    if (keySize == 4) {
+        uint32_t key;
+        NSTDLIB_INLINE_MEMCPY(&key, object, 4);
+        return key ^ signFlip;
+    } else {
+        uint64_t key;
+        NSTDLIB_INLINE_MEMCPY(&key, object, 8);
+        return key ^ signFlip;
+    }
+}
+
+static boolean radixSort(struct NVector* vector, uint32_t keyOffset, uint32_t keySize, boolean isSigned) {
+
+    NVectorSize objectsCount = vector->objectsCount;
+    uint32_t objectSize = vector->objectSize;
+    if (((keySize != 4) && (keySize != 8)) || (keyOffset + keySize > objectSize)) return False;
+    if (objectsCount < 2) return True;
+
+    // Flipping the sign bit maps signed keys to unsigned keys of the same order,
+    uint64_t signFlip = isSigned ? (1ULL << ((keySize<<3)-1)) : 0;
+
+    // Compute the histograms of all digits (bytes) in a single pass,
+    NVectorSize histograms[8][256];
+    NSystemUtils.memset(histograms, 0, sizeof(histograms));
+    uint8_t* source = vector->objects;
+    for (NVectorSize i=0; i<objectsCount; i++) {
+        uint64_t key = readRadixKey(&source[i * objectSize + keyOffset], keySize, signFlip);
+        for (uint32_t digit=0; digit<keySize; digit++) histograms[digit][(key >> (digit<<3)) & 0xff]++;
+    }
+
+    uint8_t* buffer = NMALLOC(objectsCount * (int64_t) objectSize, "NVector.radixSort() buffer");
+    if (!buffer) return False;
+    uint8_t* destination = buffer;
+
+    for (uint32_t digit=0; digit<keySize; digit++) {
+
+        // Skip digits shared by all keys,
+        NVectorSize* histogram = histograms[digit];
+        uint64_t firstKey = readRadixKey(&source[keyOffset], keySize, signFlip);
+        if (histogram[(firstKey >> (digit<<3)) & 0xff] == objectsCount) continue;
+
+        // Turn counts into offsets,
+        NVectorSize offset=0;
+        for (int32_t i=0; i<256; i++) {
+            NVectorSize count = histogram[i];
+            histogram[i] = offset;
+            offset += count;
+        }
+
+        // Scatter,
+        int32_t shift = digit<<3;
+        // Keys alone are moved through memcpy too, since allocations (and objects) may not be
+        // aligned to the key size,
+        if ((objectSize == keySize) && (keySize == 4)) {
+            for (NVectorSize i=0; i<objectsCount; i++) {
+                uint32_t key;
+                NSTDLIB_INLINE_MEMCPY(&key, &source[i*4], 4);
+                NSTDLIB_INLINE_MEMCPY(&destination[(histogram[((key ^ signFlip) >> shift) & 0xff]++) * 4], &key, 4);
+            }
+        } else if ((objectSize == keySize) && (keySize == 8)) {
+            for (NVectorSize i=0; i<objectsCount; i++) {
+                uint64_t key;
+                NSTDLIB_INLINE_MEMCPY(&key, &source[i*8], 8);
+                NSTDLIB_INLINE_MEMCPY(&destination[(histogram[((key ^ signFlip) >> shift) & 0xff]++) * 8], &key, 8);
+            }
+        } else {
+            for (NVectorSize i=0; i<objectsCount; i++) {
+                uint8_t* object = &source[i * objectSize];
+                uint64_t key = readRadixKey(&object[keyOffset], keySize, signFlip);
+                NSTDLIB_INLINE_MEMCPY(&destination[(histogram[(key >> shift) & 0xff]++) * objectSize], object, objectSize);
+            }
+        }
+
+        uint8_t* temp = source;
+        source = destination;
+        destination = temp;
+    }
+
+    // Make sure the result ends up in the vector,
+    if (source != vector->objects) NSystemUtils.memcpy(vector->objects, source, objectsCount * (int64_t) objectSize);
+    NFREE(buffer, "NVector.radixSort() buffer");
+
+    return True;
+}
+
+static NVectorSize lowerBound(struct NVector* vector, const void* object, Comparator comparator) {
+    uint8_t* objects = vector->objects;
+    NVectorSize low=0, high=vector->objectsCount;
+    while (low < high) {
+        NVectorSize middle = low + ((high - low)>>1);
+        if (comparator(&objects[middle * vector->objectSize], object) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static NVectorIndex binarySearch(struct NVector* vector, const void* object, Comparator comparator) {
+    NVectorSize index = lowerBound(vector, object, comparator);
+    if ((index < vector->objectsCount) && !comparator(&((uint8_t*) vector->objects)[index * vector->objectSize], object)) return index;
+    return -1;
+}
+
 const struct NVector_Interface NVector = {
     .initialize = initialize,
     .create = create,
@@ -181,5 +722,19 @@ const struct NVector_Interface NVector = {
     .getFirstInstanceIndex = getFirstInstanceIndex,
     .remove = remove,
     .size = size,
-    .resize = resize
+    .resize = resize,
+    .setGrowthPolicy = setGrowthPolicy,
+    .ensureCapacity = ensureCapacity,
+    .pushBackBulk = pushBackBulk,
+    .insertRange = insertRange,
+    .removeRange = removeRange,
+    .removeIf = removeIf,
+    .swapRemove = swapRemove,
+    .sort = sort,
+    .stableSort = stableSort,
+    .radixSort = radixSort,
+    .binarySearch = binarySearch,
+    .lowerBound = lowerBound,
+    .countInstances = countInstances,
+    .findAllInstances = findAllInstances
 };
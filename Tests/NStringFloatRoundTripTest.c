@@ -0,0 +1,66 @@
+// Checks that NString.appendFloat() and appendDouble() output reads back as the same value. Every
+// finite float32 is checked, then 1,000,000 random doubles. Takes about 20 minutes. Build with the
+// library sources and a backend:
+//   gcc -O2 -IIncludes *.c Backends/Linux/NSystemUtils.c Tests/NStringFloatRoundTripTest.c -o NStringFloatRoundTripTest -lm
+
+#include <NString.h>
+#include <NSystemUtils.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RANDOM_DOUBLES_COUNT 1000000
+
+static uint64_t nextRandom(uint64_t* state) {
+    // xorshift64,
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+void NMain(int argc, char* argv[]) {
+
+    struct NString string;
+    NString.initialize(&string, "");
+
+    // Every finite float32,
+    uint64_t floatsCount=0, floatFailuresCount=0;
+    for (uint64_t i=0; i<=0xffffffffULL; i++) {
+        uint32_t bits = (uint32_t) i;
+        float value;
+        NSystemUtils.memcpy(&value, &bits, sizeof(float));
+        if (NSystemUtils.isNaN(value) || NSystemUtils.isInf(value)) continue;
+
+        NString.set(&string, "");
+        NString.appendFloat(&string, value);
+        float readValue = strtof(NString.get(&string), 0);
+        floatsCount++;
+        if (NSystemUtils.memcmp(&readValue, &value, sizeof(float))) {
+            if (floatFailuresCount++ < 10) printf("Float 0x%08x gave %s\n", bits, NString.get(&string));
+        }
+    }
+    printf("Floats: %llu checked, %llu failed\n", (unsigned long long) floatsCount, (unsigned long long) floatFailuresCount);
+
+    // Random doubles, over all exponents,
+    uint64_t randomState = 0x9e3779b97f4a7c15ULL;
+    uint64_t doublesCount=0, doubleFailuresCount=0;
+    while (doublesCount < RANDOM_DOUBLES_COUNT) {
+        uint64_t bits = nextRandom(&randomState);
+        double value;
+        NSystemUtils.memcpy(&value, &bits, sizeof(double));
+        if (NSystemUtils.isNaN(value) || NSystemUtils.isInf(value)) continue;
+
+        NString.set(&string, "");
+        NString.appendDouble(&string, value);
+        double readValue = strtod(NString.get(&string), 0);
+        doublesCount++;
+        if (NSystemUtils.memcmp(&readValue, &value, sizeof(double))) {
+            if (doubleFailuresCount++ < 10) printf("Double 0x%016llx gave %s\n", (unsigned long long) bits, NString.get(&string));
+        }
+    }
+    printf("Doubles: %llu checked, %llu failed\n", (unsigned long long) doublesCount, (unsigned long long) doubleFailuresCount);
+
+    NString.destroy(&string);
+}